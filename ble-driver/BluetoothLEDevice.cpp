@@ -10,4 +10,14 @@ namespace Bluetooth
 				
 		return m_IsConnected;
 	}
+
+	bool BluetoothLEDevice::ConnectWhenSeen(const ScanFilter& filter, uint32_t timeout)
+	{
+		BluetoothLEPeripheral peripheral;
+		m_IsConnected = ConnectWhenSeenImpl(filter, timeout, &peripheral);
+		if (m_IsConnected)
+			m_ConnectedPeripheral = peripheral;
+
+		return m_IsConnected;
+	}
 }
@@ -3,6 +3,7 @@
 
 // user libraries
 #include "Models/BluetoothLEPeripheral.h"
+#include "Models/ScanFilter.h"
 #include "Models/Services.h"
 
 namespace Bluetooth
@@ -14,7 +15,7 @@ namespace Bluetooth
 	class BluetoothLEDevice
 	{
 	public:
-		enum Role;
+		enum Role : uint8_t;
 
 		/// 
 		/// Constructs a new BLE Device
@@ -73,18 +74,31 @@ namespace Bluetooth
 		virtual bool StartAdvertise(bool autoAdvertise = true) const = 0;
 
 		/// 
-		/// Starts the device as a Central to scan for public Peripherals. It relies 
-		/// on the driver to have a specific timeout if no device has been found, the
-		/// amount of times it tries to wait for the timeout is specified by the 
-		/// 'timeout' argument.\n
+		/// Starts the device as a Central to scan for public Peripherals. It scans until
+		/// the array is full or the timeout has passed.\n
 		///
 		/// @param peripherals			Array to Peripherals to store
 		/// @param len					Length of the array of Peripherals
 		/// @param found				Amount of Peripherals found
-		/// @param timeout				Maximum tries to stop scanning
+		/// @param timeout				Maximum time to scan [ms]
+		/// @param filter				Only stores the Peripherals matching the filter (may be NULL)
 		/// @return	true if operation completed succesfully		
 		/// 
-		virtual bool ScanPeripherals(BluetoothLEPeripheral* peripherals, uint8_t len, uint8_t* found, uint8_t timeout = 10) const = 0;
+		virtual bool ScanPeripherals(BluetoothLEPeripheral* peripherals, uint8_t len, uint8_t* found, uint32_t timeout = 1000, const ScanFilter* filter = NULL) const = 0;
+
+		/// 
+		/// Starts the device as a Central to scan for Peripherals and reports every
+		/// advertisement to the callback as soon as it is received. The same Peripheral
+		/// is reported again for each of its advertisements. It scans until the callback
+		/// returns false or the timeout has passed.\n
+		///
+		/// @param callback				Called for each advertisement
+		/// @param context				Passed to the callback
+		/// @param timeout				Maximum time to scan [ms]
+		/// @param filter				Only reports the advertisements matching the filter (may be NULL)
+		/// @return	true if operation completed succesfully		
+		/// 
+		virtual bool ScanPeripherals(ScanCallback callback, void* context, uint32_t timeout, const ScanFilter* filter = NULL) const = 0;
 		
 		/// 
 		/// Starts the BLE Device as a Central to connect with a Peripheral 
@@ -94,6 +108,17 @@ namespace Bluetooth
 		/// 
 		bool Connect(const BluetoothLEPeripheral& peripheral);
 
+		/// 
+		/// Starts the BLE Device as a Central to scan for a Peripheral matching the filter and
+		/// connects with it as soon as its first advertisement is received, so there is no
+		/// need to wait for a full scan (e.g. to reconnect after the Peripheral rebooted).
+		///
+		/// @param filter				Filter which selects the Peripheral
+		/// @param timeout				Maximum time to scan for the Peripheral [ms]
+		/// @return	true if connected, see GetConnectedPeripheral for the Peripheral
+		/// 
+		bool ConnectWhenSeen(const ScanFilter& filter, uint32_t timeout = 5000);
+
 		/// 
 		/// Gets the connected Peripheral, if it isn't connected it'll return NULL
 		///
@@ -139,7 +164,7 @@ namespace Bluetooth
 			m_Timeout = a_Timeout;
 		}
 
-		enum Role
+		enum Role : uint8_t
 		{
 			ROLE_NONE,
 			NONE_PERIPHERAL,
@@ -150,6 +175,7 @@ namespace Bluetooth
 
 	protected:
 		virtual bool ConnectImpl(const BluetoothLEPeripheral& peripheral) = 0;
+		virtual bool ConnectWhenSeenImpl(const ScanFilter& filter, uint32_t timeout, BluetoothLEPeripheral* peripheral) = 0;
 
 	private:
 		uint16_t m_Interval;
@@ -0,0 +1,145 @@
+#include "RN4020BeaconScheduler.h"
+
+namespace Bluetooth
+{
+	namespace Drivers
+	{
+		RN4020BeaconScheduler::RN4020BeaconScheduler(const RN4020Driver& driver, uint8_t depth)
+			: m_Pipeline(driver, depth),
+			  m_Count(0),
+			  m_Current(0),
+			  m_Started(false),
+			  m_Rotation(0),
+			  m_Interval(0),
+			  m_Window(0),
+			  m_ContentSet(false),
+			  m_Queued(0),
+			  m_Completed(0),
+			  m_Failed(0),
+			  m_Late(0)
+		{
+		}
+
+		bool RN4020BeaconScheduler::Add(const Advertisement& advertisement)
+		{
+			if (advertisement.IsEmpty() || m_Count >= MAX_ADVERTISEMENTS)
+				return false;
+
+			m_Advertisements[m_Count++] = advertisement;
+			return true;
+		}
+
+		void RN4020BeaconScheduler::Clear()
+		{
+			if (m_Started)
+				return;
+
+			m_Count = 0;
+			m_Current = 0;
+		}
+
+		bool RN4020BeaconScheduler::Start(uint32_t rotation, uint16_t interval, uint16_t window)
+		{
+			if (m_Count == 0 || rotation == 0)
+				return false;
+
+			m_Rotation = rotation;
+			m_Interval = interval;
+			m_Window = window;
+
+			m_Queued = 0;
+			m_Completed = 0;
+			m_Failed = 0;
+			m_Late = 0;
+
+			m_Start = Clock::now();
+			m_Next = m_Start;
+			m_Started = true;
+
+			return true;
+		}
+
+		uint32_t RN4020BeaconScheduler::Poll()
+		{
+			if (!m_Started)
+				return 0;
+
+			// take the AOKs which have arrived since the last call, so the statistics are up to
+			// date and the pipeline rarely has to wait for a response when it's full
+			m_Pipeline.Poll();
+
+			Clock::time_point now = Clock::now();
+			if (now >= m_Next)
+			{
+				const Advertisement& advertisement = m_Advertisements[m_Current];
+				m_Current = (m_Current + 1) % m_Count;
+
+				// a full pipeline completes the oldest rotation first, so this may wait for an AOK
+				if (m_Pipeline.Broadcast(advertisement, OnBroadcast, this) && m_Pipeline.Advertise(m_Interval, m_Window, OnAdvertise, this))
+					++m_Queued;
+				else
+					++m_Failed;
+
+				// keep the pace of the rotation, but don't catch up on missed ones in a burst
+				m_Next += std::chrono::milliseconds(m_Rotation);
+
+				now = Clock::now();
+				while (m_Next <= now)
+				{
+					m_Next += std::chrono::milliseconds(m_Rotation);
+					++m_Late;
+				}
+			}
+
+			std::chrono::milliseconds wait = std::chrono::duration_cast<std::chrono::milliseconds>(m_Next - now);
+			return static_cast<uint32_t>(wait.count());
+		}
+
+		bool RN4020BeaconScheduler::Stop()
+		{
+			if (!m_Started)
+				return false;
+
+			m_Pipeline.StopAdvertisement();
+			bool drained = m_Pipeline.Drain();
+
+			m_Stop = Clock::now();
+			m_Started = false;
+
+			return drained && m_Failed == 0;
+		}
+
+		RN4020BeaconScheduler::Statistics RN4020BeaconScheduler::GetStatistics() const
+		{
+			Clock::time_point end = m_Started ? Clock::now() : m_Stop;
+			std::chrono::milliseconds elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - m_Start);
+
+			Statistics statistics;
+			statistics.Queued = m_Queued;
+			statistics.Completed = m_Completed;
+			statistics.Failed = m_Failed;
+			statistics.Late = m_Late;
+			statistics.Elapsed = static_cast<uint32_t>(elapsed.count());
+			statistics.RequestedRate = m_Rotation > 0 ? 1000.0f / m_Rotation : 0.0f;
+			statistics.AchievedRate = statistics.Elapsed > 0 ? m_Completed * 1000.0f / statistics.Elapsed : 0.0f;
+
+			return statistics;
+		}
+
+		void RN4020BeaconScheduler::OnBroadcast(void* context, bool success, const char* /* response */)
+		{
+			RN4020BeaconScheduler* scheduler = static_cast<RN4020BeaconScheduler*>(context);
+			scheduler->m_ContentSet = success;
+		}
+
+		void RN4020BeaconScheduler::OnAdvertise(void* context, bool success, const char* /* response */)
+		{
+			RN4020BeaconScheduler* scheduler = static_cast<RN4020BeaconScheduler*>(context);
+
+			if (success && scheduler->m_ContentSet)
+				++scheduler->m_Completed;
+			else
+				++scheduler->m_Failed;
+		}
+	}
+}
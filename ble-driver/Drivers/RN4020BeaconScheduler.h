@@ -0,0 +1,162 @@
+#ifndef RN4020_BEACON_SCHEDULER_H_
+#define RN4020_BEACON_SCHEDULER_H_
+
+// user libraries
+#include "RN4020Pipeline.h"
+#include "../Models/Advertisement.h"
+
+// std libraries
+#include <chrono>
+
+namespace Bluetooth
+{
+	namespace Drivers
+	{
+		///
+		/// Rotates the RN4020 through a ring of pre-encoded advertisements (see AdvertisementData),
+		/// so one module broadcasts as several beacons. Each rotation queues the advertisement (N)
+		/// and restarts advertising (A) on a RN4020Pipeline. Poll collects the AOKs received so
+		/// far without blocking, so the host only waits for one when the pipeline is still full
+		/// instead of on every command.\n
+		/// Call Poll from the application loop, it returns the time until the next rotation is
+		/// due. The driver may not be used until Stop has been called.
+		///
+		class RN4020BeaconScheduler
+		{
+		public:
+			typedef std::chrono::steady_clock Clock;
+
+			static const uint8_t MAX_ADVERTISEMENTS = 16;
+
+			///
+			/// Requested and achieved rotations since Start
+			///
+			struct Statistics
+			{
+				///
+				/// Rotations queued
+				///
+				uint32_t Queued;
+
+				///
+				/// Rotations of which both the N and A command were acknowledged
+				///
+				uint32_t Completed;
+
+				///
+				/// Rotations of which a command failed or wasn't sent
+				///
+				uint32_t Failed;
+
+				///
+				/// Rotations skipped because Poll was called too late (or blocked on a full pipeline)
+				///
+				uint32_t Late;
+
+				///
+				/// Time since Start [ms]
+				///
+				uint32_t Elapsed;
+
+				///
+				/// Rotations per second as configured
+				///
+				float RequestedRate;
+
+				///
+				/// Completed rotations per second
+				///
+				float AchievedRate;
+			};
+
+			///
+			/// Constructs a scheduler without advertisements
+			///
+			/// @param driver		Driver to broadcast with
+			/// @param depth		Maximum amount of outstanding commands (1 up to RN4020Pipeline::MAX_DEPTH)
+			///
+			explicit RN4020BeaconScheduler(const RN4020Driver& driver, uint8_t depth = RN4020Pipeline::MAX_DEPTH);
+
+			///
+			/// Adds an advertisement to the end of the ring
+			///
+			/// @param advertisement	Encoded advertisement (copied)
+			/// @return	false if it is empty or the ring is full
+			///
+			bool Add(const Advertisement& advertisement);
+
+			///
+			/// Removes all advertisements, only while stopped
+			///
+			void Clear();
+
+			///
+			/// Starts rotating, the first advertisement is queued by the next Poll
+			///
+			/// @param rotation		Time each advertisement is broadcasted [ms]
+			/// @param interval		Interval between advertisements [ms] (0 with window 0 for the default)
+			/// @param window		Total time to advertise, should be at least the rotation [ms]
+			/// @return	false if there are no advertisements or the rotation is 0
+			///
+			bool Start(uint32_t rotation, uint16_t interval = 0, uint16_t window = 0);
+
+			///
+			/// Completes the responses received so far and queues the next advertisement when
+			/// it is due
+			///
+			/// @return	time until the next rotation is due [ms], 0 when not started
+			///
+			uint32_t Poll();
+
+			///
+			/// Completes the outstanding commands and stops advertising
+			///
+			/// @return	true if no command failed since Start
+			///
+			bool Stop();
+
+			///
+			/// Gets the requested and achieved rotations since Start (up to Stop)
+			///
+			/// @return				the statistics
+			///
+			Statistics GetStatistics() const;
+
+			uint8_t GetCount() const
+			{
+				return m_Count;
+			}
+
+			bool IsStarted() const
+			{
+				return m_Started;
+			}
+
+		private:
+			RN4020Pipeline m_Pipeline;
+			Advertisement m_Advertisements[MAX_ADVERTISEMENTS];
+			uint8_t m_Count;
+			uint8_t m_Current;
+
+			bool m_Started;
+			uint32_t m_Rotation;
+			uint16_t m_Interval;
+			uint16_t m_Window;
+			Clock::time_point m_Start;
+			Clock::time_point m_Stop;
+			Clock::time_point m_Next;
+
+			// set by the completion of N, read by the completion of A of the same rotation
+			bool m_ContentSet;
+			uint32_t m_Queued;
+			uint32_t m_Completed;
+			uint32_t m_Failed;
+			uint32_t m_Late;
+
+			static void OnBroadcast(void* context, bool success, const char* response);
+			static void OnAdvertise(void* context, bool success, const char* response);
+		};
+	}
+}
+
+#endif // !RN4020_BEACON_SCHEDULER_H_
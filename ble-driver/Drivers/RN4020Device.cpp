@@ -1,13 +1,15 @@
 ﻿#include "RN4020Device.h"
 #include <ctime>
 
+// maximum time between the connect request and the Connected status [ms]
+#define CONNECT_TIMEOUT 2000
 
 using namespace Bluetooth::Drivers;
 
 namespace Bluetooth
 {
 	RN4020Device::RN4020Device(const Serial::ISerial& serial)
-		: m_RN4020(serial), m_ShouldReboot(false)
+		: m_RN4020(serial), m_ShouldReboot(false), m_GattCache(NULL)
 	{
 		m_RN4020.ResetDefaults();
 	}
@@ -17,7 +19,7 @@ namespace Bluetooth
 		// BTA= + 6 byte mac address
 		// (Dump flushes internally so we don't need to read all of the dump)
 		char buf[17];
-		if (!m_RN4020.Dump(buf, sizeof(buf) - 1))
+		if (!m_RN4020.Dump(buf, sizeof(buf)))
 			return false;
 
 		// skip BTA=
@@ -67,7 +69,7 @@ namespace Bluetooth
 		return m_RN4020.Advertise(GetInterval(), GetTimeout());
 	}
 
-	bool RN4020Device::ScanPeripherals(BluetoothLEPeripheral* peripherals, uint8_t len, uint8_t* found, uint8_t timeout) const
+	bool RN4020Device::ScanPeripherals(BluetoothLEPeripheral* peripherals, uint8_t len, uint8_t* found, uint32_t timeout, const ScanFilter* filter) const
 	{
 		if (!CheckReboot())
 			return false;
@@ -75,28 +77,100 @@ namespace Bluetooth
 		if (!m_RN4020.Find(0, 0))
 			return false;
 
-		if (!m_RN4020.ReadScan(peripherals, len, found, timeout))
+		if (!m_RN4020.ReadScan(peripherals, len, found, timeout, filter))
 			return false;
 		
 		return m_RN4020.StopScan();
 	}
 
+	bool RN4020Device::ScanPeripherals(ScanCallback callback, void* context, uint32_t timeout, const ScanFilter* filter) const
+	{
+		if (!CheckReboot())
+			return false;
+
+		if (!m_RN4020.Find(0, 0))
+			return false;
+
+		if (!m_RN4020.ReadScan(callback, context, timeout, NULL, filter))
+			return false;
+
+		return m_RN4020.StopScan();
+	}
+
 	bool RN4020Device::ConnectImpl(const BluetoothLEPeripheral& peripheral)
 	{
 		if (!m_RN4020.Establish(!peripheral.GetIsRandomMAC(), peripheral.GetMACAddress()))
 			return false;
 
 		char buf[12]; // 'Connected\r\n'
-		if (!m_RN4020.WaitAnything(buf, sizeof(buf)))
+		if (!m_RN4020.WaitAnything(buf, sizeof(buf), NULL, CONNECT_TIMEOUT))
 			return false;
 
-		if (strncmp(buf, "Connected", 9) != 0)
+		if (RN4020Driver::ClassifyLine(buf) != RN4020Driver::LINE_CONNECTED)
 			return false;
 
 		
 		return true;
 	}
 
+	bool RN4020Device::ConnectWhenSeenImpl(const ScanFilter& filter, uint32_t timeout, BluetoothLEPeripheral* peripheral)
+	{
+		if (!CheckReboot())
+			return false;
+
+		if (!m_RN4020.Find(0, 0))
+			return false;
+
+		if (!m_RN4020.ReadNextScan(peripheral, Util::Deadline(timeout), &filter))
+		{
+			m_RN4020.StopScan();
+			return false;
+		}
+
+		// stop and connect at once, the Peripheral is advertising right now
+		if (!m_RN4020.StopScanAndEstablish(!peripheral->GetIsRandomMAC(), peripheral->GetMACAddress()))
+			return false;
+
+		char buf[12]; // 'Connected\r\n'
+		if (m_RN4020.WaitAnything(buf, sizeof(buf), NULL, CONNECT_TIMEOUT) && RN4020Driver::ClassifyLine(buf) == RN4020Driver::LINE_CONNECTED)
+			return true;
+
+		// give up connecting
+		m_RN4020.StopConnecting();
+		return false;
+	}
+
+	bool RN4020Device::DiscoverClient(GattTable* table, bool refresh, bool* changed)
+	{
+		if (changed)
+			*changed = false;
+
+		// the cache is keyed by the Peripheral we connected to
+		const BluetoothLEPeripheral* peripheral = GetConnectedPeripheral();
+		if (m_GattCache == NULL || peripheral == NULL)
+			return m_RN4020.DiscoverClient(table);
+
+		if (!refresh)
+		{
+			const GattTable* cached = m_GattCache->Find(peripheral->GetMACAddress());
+			if (cached)
+			{
+				*table = *cached;
+				return true;
+			}
+		}
+
+		if (!m_RN4020.DiscoverClient(table))
+		{
+			// don't keep using a table which may be outdated
+			m_GattCache->Invalidate(peripheral->GetMACAddress());
+			return false;
+		}
+
+		m_GattCache->Store(peripheral->GetMACAddress(), *table, changed);
+		return true;
+	}
+
 	bool RN4020Device::CheckReboot() const
 	{
 		if (!m_ShouldReboot)
@@ -5,6 +5,7 @@
 #include "../Serial/ISerial.h"
 #include "../BluetoothLEDevice.h"
 #include "../Models/Services.h"
+#include "../Models/GattCache.h"
 
 class MACAddress;
 
@@ -66,18 +67,53 @@ namespace Bluetooth
 		bool StartAdvertise(bool autoAdvertise = true) const override;
 
 		/// 
-		/// Starts the device as a Central to scan for public Peripherals. It relies 
-		/// on the driver to have a specific timeout if no device has been found, the
-		/// amount of times it tries to wait for the timeout is specified by the 
-		/// 'timeout' argument.\n
+		/// Starts the device as a Central to scan for public Peripherals. It scans until
+		/// the array is full or the timeout has passed.\n
 		///
 		/// @param peripherals			Array to Peripherals to store
 		/// @param len					Length of the array of Peripherals
 		/// @param found				Amount of Peripherals found
-		/// @param timeout				Maximum tries to stop scanning
+		/// @param timeout				Maximum time to scan [ms]
+		/// @param filter				Only stores the Peripherals matching the filter (may be NULL)
 		/// @return	true if operation completed succesfully		
 		/// 
-		bool ScanPeripherals(BluetoothLEPeripheral* peripherals, uint8_t len, uint8_t* found, uint8_t timeout = 10) const override;
+		bool ScanPeripherals(BluetoothLEPeripheral* peripherals, uint8_t len, uint8_t* found, uint32_t timeout = 1000, const ScanFilter* filter = NULL) const override;
+
+		/// 
+		/// Starts the device as a Central to scan for Peripherals and reports every
+		/// advertisement to the callback as soon as it is received, until the callback
+		/// returns false or the timeout has passed.\n
+		///
+		/// @param callback				Called for each advertisement
+		/// @param context				Passed to the callback
+		/// @param timeout				Maximum time to scan [ms]
+		/// @param filter				Only reports the advertisements matching the filter (may be NULL)
+		/// @return	true if operation completed succesfully		
+		/// 
+		bool ScanPeripherals(ScanCallback callback, void* context, uint32_t timeout, const ScanFilter* filter = NULL) const override;
+
+		/// 
+		/// Discovers the GATT server of the connected Peripheral (LC). With a cache the table
+		/// of a known Peripheral is reused, so no listing is needed when reconnecting.
+		///
+		/// @param table				Output to store the table
+		/// @param refresh				If set, always discovers and updates the cache with the
+		///								result (e.g. when a cached handle was rejected)
+		/// @param changed				Set if the discovered table differs from the cached
+		///								table (may be NULL)
+		/// @return	true if operation completed succesfully		
+		/// 
+		bool DiscoverClient(GattTable* table, bool refresh = false, bool* changed = NULL);
+
+		/// 
+		/// Sets the cache of the discovered GATT servers used by DiscoverClient
+		///
+		/// @param cache				Cache to use (NULL to always discover)
+		/// 
+		void SetGattCache(GattCache* cache)
+		{
+			m_GattCache = cache;
+		}
 
 		const Drivers::RN4020Driver& GetDriver() const
 		{
@@ -86,11 +122,13 @@ namespace Bluetooth
 
 	protected:
 		bool ConnectImpl(const BluetoothLEPeripheral& peripheral) override;
+		bool ConnectWhenSeenImpl(const ScanFilter& filter, uint32_t timeout, BluetoothLEPeripheral* peripheral) override;
 
 	private:
 		const Drivers::RN4020Driver m_RN4020;
 		
 		mutable bool m_ShouldReboot;
+		GattCache* m_GattCache;
 
 		bool CheckReboot() const;
 	};
@@ -2,14 +2,18 @@
 
 // std libraries
 #include <string.h>
-#include <cstdio>
+#include <climits>
 #include <cstdlib>
 #include "../Serial/DelimiterSerial.h"
+#include "../Util/Hex.h"
 
 
 // RN4020Driver Constants
 #define MAX_SERIALIZED_NAME 15
 #define MAX_NAME_LEN 20
+#define REBOOT_TIMEOUT 2000 // ms
+#define DUMP_QUIET_TIME 100 // ms
+#define STATUS_TIMEOUT 1000 // ms
 
 namespace
 {
@@ -27,6 +31,59 @@ namespace
 		*p = '\0';
 	}
 
+	// parses a 16 bit (4 hex) or 128 bit (32 hex) UUID, returns the amount of hex chars (0 if invalid)
+	uint8_t parseUUID(const char* hex, Bluetooth::UUID* uuid)
+	{
+		uint8_t digits = 0;
+		while (digits <= 32 && Util::HexValue(hex[digits]) >= 0)
+			++digits;
+
+		if (digits == 4)
+		{
+			uint32_t shortUUID;
+			Util::ParseHex(hex, &shortUUID, 4);
+			*uuid = Bluetooth::UUID(static_cast<uint16_t>(shortUUID));
+		}
+		else if (digits == 32)
+		{
+			uint8_t longUUID[16];
+			Util::DecodeHex(hex, longUUID, sizeof(longUUID));
+			*uuid = Bluetooth::UUID(longUUID);
+		}
+		else
+		{
+			return 0;
+		}
+
+		return digits;
+	}
+
+	// a line of the LS/LC listing: a service UUID or "  UUID,handle,V/C" (LS) or "  UUID,handle,property" (LC)
+	bool parseListingLine(const char* line, Bluetooth::GattTable* table, bool* full)
+	{
+		Bluetooth::UUID uuid;
+		if (strncmp(line, "  ", 2) != 0)
+		{
+			if (parseUUID(line, &uuid) == 0)
+				return false;
+
+			*full |= !table->AddService(uuid);
+			return true;
+		}
+
+		uint16_t handle;
+		const char* attribute = Bluetooth::Drivers::ParseCharacteristic(line, &uuid, &handle);
+		if (attribute == NULL)
+			return false;
+
+		uint32_t property = 0;
+		bool isConfiguration = *attribute == 'C';
+		if (*attribute != 'V' && *attribute != 'C' && Util::ParseHex(attribute, &property, 2) == 0)
+			return false;
+
+		*full |= !table->AddCharacteristic(uuid, handle, static_cast<uint8_t>(property), isConfiguration);
+		return true;
+	}
 }
 
 namespace Bluetooth
@@ -174,7 +231,7 @@ namespace Bluetooth
 		bool RN4020Driver::SetTiming(uint16_t interval, uint16_t latency, uint16_t timeout) const
 		{
 			char buf[16] = {0};
-			snprintf(buf, 15, "%04X,%04X,%04X", interval, latency, timeout);
+			FormatHex16List(buf, interval, latency, &timeout);
 
 			return Set("ST", buf);
 		}
@@ -230,7 +287,7 @@ namespace Bluetooth
 				return Set("A", NULL);
 
 			char buf[11] = {0};
-			snprintf(buf, 10, "%04X,%04X", interval, window);
+			FormatHex16List(buf, interval, window, NULL);
 
 			return Set("A", buf);
 		}
@@ -255,7 +312,7 @@ namespace Bluetooth
 				return Set("F", NULL);
 
 			char buf[11] = {0};
-			snprintf(buf, 10, "%04X,%04X", interval, window);
+			FormatHex16List(buf, interval, window, NULL);
 
 			return Set("F", buf);
 		}
@@ -287,13 +344,23 @@ namespace Bluetooth
 
 		bool RN4020Driver::Broadcast(uint8_t data[25], uint8_t len) const
 		{
+			if (len > 25)
+				return false;
+
 			char buf[51] = {0};
-			for (uint8_t i = 0; i < len; ++i)
-				snprintf(buf + 2, 3, "%02X", data[i]);
+			Util::EncodeHexBytes(data, len, buf);
 
 			return Set("N", buf);
 		}
 
+		bool RN4020Driver::Broadcast(const Advertisement& advertisement) const
+		{
+			if (advertisement.IsEmpty())
+				return false;
+
+			return Set("N", advertisement.GetHex());
+		}
+
 		void RN4020Driver::Dormant() const
 		{
 			Set("O", NULL);
@@ -301,10 +368,15 @@ namespace Bluetooth
 
 		bool RN4020Driver::Dump(char* buf, uint8_t len) const
 		{
-			if (!Get("D", buf, len, false))
+			if (!Get("D", buf, len, NULL))
 				return false;
 
-			m_Serial.Flush();
+			// skip the rest of the dump until the module is quiet, flushing right away would
+			// leave the lines it is still sending for the next command
+			char line[BUF_LEN];
+			while (WaitAnything(line, sizeof(line), NULL, DUMP_QUIET_TIME))
+				;
+
 			return true;
 		}
 
@@ -317,16 +389,16 @@ namespace Bluetooth
 				return false;
 
 			// when it is booted it puts out CMD
-			if (!WaitAnything(buf, sizeof(buf)))
+			if (!WaitAnything(buf, sizeof(buf), NULL, REBOOT_TIMEOUT))
 				return false;
 
-			return strncmp(buf, "CMD", 3) == 0;
+			return ClassifyLine(buf) == LINE_CMD;
 		}
 
 		bool RN4020Driver::UpdateTimings(uint16_t interval, uint16_t latency, uint16_t timeout) const
 		{
 			char buf[16] = {0};
-			snprintf(buf, 15, "%04X,%04X,%04X", interval, latency, timeout);
+			FormatHex16List(buf, interval, latency, &timeout);
 
 			return Set("T", buf);
 		}
@@ -343,7 +415,27 @@ namespace Bluetooth
 
 		bool RN4020Driver::StopScan() const
 		{
-			return Set("X", NULL);
+			if (!Send("X", NULL))
+				return false;
+
+			// the advertisements received before the module handled X come first
+			return SkipToStatus(Util::Deadline(STATUS_TIMEOUT));
+		}
+
+		bool RN4020Driver::StopScanAndEstablish(bool usePublicAddress, const MACAddress& macAddress) const
+		{
+			char buf[15] = {(usePublicAddress ? '0' : '1'), ','};
+			macAddress.ToCharArray(buf + 2, 13, '\0');
+
+			if (!Send("X", NULL) || !Send("E", buf))
+				return false;
+
+			// both statuses are read, so a rejected X doesn't leave the AOK of E behind
+			Util::Deadline deadline(STATUS_TIMEOUT);
+			bool stopped = SkipToStatus(deadline);
+			bool established = SkipToStatus(deadline);
+
+			return stopped && established;
 		}
 
 		bool RN4020Driver::StopAdvertisement() const
@@ -356,14 +448,14 @@ namespace Bluetooth
 			return Set("Z", NULL);
 		}
 
-		bool RN4020Driver::ReadScan(BluetoothLEPeripheral* devices, uint8_t len, uint8_t* found, uint8_t timeout) const
+		bool RN4020Driver::ReadScan(BluetoothLEPeripheral* devices, uint8_t len, uint8_t* found, uint32_t timeout, const ScanFilter* filter) const
 		{
-			char buf[64];
+			// a single budget for the whole scan
+			Util::Deadline deadline(timeout);
 
-			int32_t received;
 			uint8_t index = 0;
-			while (index < len && WaitAnything(buf, sizeof(buf), NULL, timeout))
-				devices[index++] = ParseScanLine(buf);
+			while (index < len && ReadNextScan(devices + index, deadline, filter))
+				++index;
 
 			if (found)
 				*found = index;
@@ -371,6 +463,54 @@ namespace Bluetooth
 			return true;
 		}
 
+		bool RN4020Driver::ReadScan(ScanCallback callback, void* context, uint32_t timeout, uint32_t* reported, const ScanFilter* filter) const
+		{
+			Util::Deadline deadline(timeout);
+
+			uint32_t count = 0;
+			BluetoothLEPeripheral peripheral;
+			while (ReadNextScan(&peripheral, deadline, filter))
+			{
+				++count;
+				if (!callback(context, peripheral))
+					break;
+			}
+
+			if (reported)
+				*reported = count;
+
+			return true;
+		}
+
+		bool RN4020Driver::ReadNextScan(BluetoothLEPeripheral* peripheral, const Util::Deadline& deadline, const ScanFilter* filter) const
+		{
+			// a scan line is up to 72 characters (MAC,type,name,uuid,rssi), receiving it in place
+			// never truncates it, so the filter and the parser always see the whole line
+			const char* line;
+			while (m_Serial.ReceiveInPlaceUntil(&line, deadline) > 0)
+			{
+				// rejected advertisements aren't parsed at all
+				if (filter && !filter->Matches(line))
+					continue;
+
+				// e.g. a status line of the connection
+				if (ParseScanLine(line, peripheral))
+					return true;
+			}
+
+			return false;
+		}
+
+		bool RN4020Driver::DiscoverServer(GattTable* table) const
+		{
+			return Discover("LS", table);
+		}
+
+		bool RN4020Driver::DiscoverClient(GattTable* table) const
+		{
+			return Discover("LC", table);
+		}
+
 		bool RN4020Driver::ListServerServices(UUID* services, uint8_t len, uint8_t* listed) const
 		{
 			return ListServices("LS", services, len, listed);
@@ -416,26 +556,74 @@ namespace Bluetooth
 		bool RN4020Driver::WriteClientConfigurationByUUID(uint16_t uuid, bool enable) const
 		{
 			char buf[7] = { 0 };
-			snprintf(buf, sizeof(buf), "%04X,%d", uuid, enable ? 1 : 0);
+			char* ptr = Util::EncodeHex(uuid, 4, buf);
+			*ptr++ = ',';
+			*ptr = enable ? '1' : '0';
 
 			return Set("CUWC", buf);
 		}
 
-		bool RN4020Driver::Set(const char* command, const char* param) const
+		bool RN4020Driver::WriteServerValueByUUID(uint16_t uuid, const uint8_t* value, uint8_t len) const
 		{
-			if (m_Serial.SendRaw(command, strlen(command)) == -1)
-				return false;
+			return WriteCharacteristicValue("SUW", uuid, value, len);
+		}
+
+		bool RN4020Driver::WriteServerValueByHandle(uint16_t handle, const uint8_t* value, uint8_t len) const
+		{
+			return WriteCharacteristicValue("SHW", handle, value, len);
+		}
+
+		bool RN4020Driver::ReadServerValueByUUID(uint16_t uuid, uint8_t* value, uint8_t len, uint8_t* read) const
+		{
+			return ReadCharacteristicValue("SUR", uuid, false, value, len, read);
+		}
 
-			if (param)
+		bool RN4020Driver::ReadServerValueByHandle(uint16_t handle, uint8_t* value, uint8_t len, uint8_t* read) const
+		{
+			return ReadCharacteristicValue("SHR", handle, false, value, len, read);
+		}
+
+		bool RN4020Driver::WriteClientValueByUUID(uint16_t uuid, const uint8_t* value, uint8_t len) const
+		{
+			return WriteCharacteristicValue("CUWV", uuid, value, len);
+		}
+
+		bool RN4020Driver::WriteClientValueByHandle(uint16_t handle, const uint8_t* value, uint8_t len) const
+		{
+			return WriteCharacteristicValue("CHW", handle, value, len);
+		}
+
+		bool RN4020Driver::ReadClientValueByUUID(uint16_t uuid, uint8_t* value, uint8_t len, uint8_t* read) const
+		{
+			return ReadCharacteristicValue("CURV", uuid, true, value, len, read);
+		}
+
+		bool RN4020Driver::ReadClientValueByHandle(uint16_t handle, uint8_t* value, uint8_t len, uint8_t* read) const
+		{
+			return ReadCharacteristicValue("CHR", handle, true, value, len, read);
+		}
+
+		bool RN4020Driver::Send(const char* command, const char* param) const
+		{
+			return SendCommand(m_Serial, command, param);
+		}
+
+		bool RN4020Driver::SendCommand(const Serial::ISerial& lines, const char* command, const char* param)
+		{
+			// command[,param] and the delimiter in a single write
+			Serial::SerialBuffer buffers[] =
 			{
-				if (m_Serial.SendRaw(",", 1) == -1)
-					return false;
-				if (m_Serial.SendRaw(param, strlen(param)) == -1)
-					return false;
-			}
+				{ command, static_cast<uint32_t>(strlen(command)) },
+				{ ",", 1 },
+				{ param, param ? static_cast<uint32_t>(strlen(param)) : 0 }
+			};
+
+			return lines.SendVector(buffers, param ? 3 : 1) != -1;
+		}
 
-			// sends the delimiter
-			if (m_Serial.Send(NULL, 0) == -1)
+		bool RN4020Driver::Set(const char* command, const char* param) const
+		{
+			if (!Send(command, param))
 				return false;
 
 			// RN4020Driver returns AOK of ERR for set commands
@@ -445,13 +633,13 @@ namespace Bluetooth
 			if (received <= 0)
 				return false;
 
-			return strncmp(buf, "AOK", 3) == 0;
+			return ClassifyLine(buf) == LINE_AOK;
 		}
 
 		bool RN4020Driver::SetHex32(const char* command, uint32_t value) const
 		{
 			char buf[10] = {0};
-			snprintf(buf, 9, "%08X", value);
+			Util::EncodeHex(value, 8, buf);
 
 			return Set(command, buf);
 		}
@@ -476,6 +664,97 @@ namespace Bluetooth
 			return tmp > 0;
 		}
 
+		void RN4020Driver::FormatHex16List(char* buf, uint16_t a, uint16_t b, const uint16_t* c)
+		{
+			char* ptr = Util::EncodeHex(a, 4, buf);
+			*ptr++ = ',';
+			ptr = Util::EncodeHex(b, 4, ptr);
+
+			if (c)
+			{
+				*ptr++ = ',';
+				ptr = Util::EncodeHex(*c, 4, ptr);
+			}
+
+			*ptr = '\0';
+		}
+
+		void RN4020Driver::FormatCommandHandle(char* buf, const char* command, uint16_t handle)
+		{
+			// at most 4 chars of the command (e.g. CUWC)
+			uint8_t i = 0;
+			for (; i < 4 && command[i]; ++i)
+				buf[i] = command[i];
+
+			buf[i] = ',';
+			*Util::EncodeHex(handle, 4, buf + i + 1) = '\0';
+		}
+
+		bool RN4020Driver::WriteCharacteristicValue(const char* command, uint16_t param, const uint8_t* value, uint8_t len) const
+		{
+			char buf[VALUE_PARAM_LEN];
+			if (!FormatCharacteristicValue(buf, param, value, len))
+				return false;
+
+			return Set(command, buf);
+		}
+
+		bool RN4020Driver::ReadCharacteristicValue(const char* command, uint16_t param, bool isClient, uint8_t* value, uint8_t len, uint8_t* read) const
+		{
+			char buf[10] = { 0 };
+			FormatCommandHandle(buf, command, param);
+
+			// decoded straight from the receive buffer
+			const char* line;
+			if (!GetInPlace(buf, &line))
+				return false;
+
+			size_t digits = strlen(line);
+			if (isClient)
+			{
+				if (digits < 3 || strncmp(line, "R,", 2) != 0 || line[digits - 1] != '.')
+					return false;
+
+				line += 2;
+				digits -= 3;
+			}
+
+			// ERR, an odd amount of digits or a value larger than the caller's memory
+			if (digits == 0 || digits % 2 != 0 || digits / 2 > len)
+				return false;
+
+			if (!Util::DecodeHexBuffer(line, value, static_cast<uint32_t>(digits / 2)))
+				return false;
+
+			if (read)
+				*read = static_cast<uint8_t>(digits / 2);
+
+			return true;
+		}
+
+		bool RN4020Driver::FormatCharacteristicValue(char* buf, uint16_t param, const uint8_t* value, uint8_t len)
+		{
+			if (len == 0 || len > MAX_VALUE_LEN)
+				return false;
+
+			char* ptr = Util::EncodeHex(param, 4, buf);
+			*ptr++ = ',';
+			*Util::EncodeHexBytes(value, len, ptr) = '\0';
+
+			return true;
+		}
+
+		bool RN4020Driver::GetInPlace(const char* command, const char** line) const
+		{
+			if (command)
+			{
+				if (m_Serial.Send(command, strlen(command)) == -1)
+					return false;
+			}
+
+			return m_Serial.ReceiveInPlace(line) > 0;
+		}
+
 		bool RN4020Driver::GetHex32(const char* command, uint32_t* value) const
 		{
 			char buf[11] = {0};
@@ -494,37 +773,48 @@ namespace Bluetooth
 			return true;
 		}
 
-		bool RN4020Driver::WaitAnything(uint8_t timeout) const
+		bool RN4020Driver::SkipToStatus(const Util::Deadline& deadline) const
+		{
+			char buf[64];
+			while (m_Serial.ReceiveUntil(buf, sizeof(buf), deadline) > 0)
+			{
+				LineType type = ClassifyLine(buf);
+				if (type == LINE_AOK || type == LINE_ERR)
+					return type == LINE_AOK;
+			}
+
+			return false;
+		}
+
+		bool RN4020Driver::WaitAnything(uint32_t timeout) const
 		{
 			char buf[64];
 			return WaitAnything(buf, sizeof(buf), NULL, timeout);
 		}
 
-		bool RN4020Driver::WaitAnything(char* buf, uint32_t len, int32_t* received, uint8_t timeout) const
+		bool RN4020Driver::WaitAnything(char* buf, uint32_t len, int32_t* received, uint32_t timeout) const
 		{
-			for (uint8_t i = 0; i < timeout; ++i)
-			{
-				if (Get(buf, len, received))
-					return true;
-			}
+			int32_t tmp = m_Serial.ReceiveUntil(buf, len, Util::Deadline(timeout));
+			if (received)
+				*received = tmp;
 
-			return false;
+			return tmp > 0;
 		}
 
 		bool RN4020Driver::ListServices(const char* command, UUID* services, uint8_t len, uint8_t* listed) const
 		{
-			char line[BUF_LEN];
+			const char* line;
 
 			uint8_t index = 0;
 
-			bool receiving = Get(command, line, sizeof(line));
+			bool receiving = GetInPlace(command, &line);
 			while (receiving && index < len && strncmp(line, "END", 3) != 0)
 			{
 				// starts with two spaces means a characteristic else its a new service
 				if (strncmp(line, "  ", 2) != 0)
 					services[index++] = UUID(line);
 
-				receiving = Get(line, sizeof(line));
+				receiving = GetInPlace(NULL, &line);
 			}
 
 			if (listed)
@@ -535,75 +825,164 @@ namespace Bluetooth
 			return true;
 		}
 
-		BluetoothLEPeripheral RN4020Driver::ParseScanLine(const char* line) const
+		bool RN4020Driver::Discover(const char* command, GattTable* table) const
+		{
+			table->Clear();
+
+			const char* line;
+			bool receiving = GetInPlace(command, &line);
+			if (receiving && ClassifyLine(line) == LINE_ERR)
+				return false;
+
+			// read up to END even if the table is full, so no listing is left behind
+			bool full = false;
+			while (receiving && strncmp(line, "END", 3) != 0)
+			{
+				parseListingLine(line, table, &full);
+				receiving = GetInPlace(NULL, &line);
+			}
+
+			return receiving && !full;
+		}
+
+		RN4020Driver::LineType RN4020Driver::ClassifyLine(const char* line)
+		{
+			if (strncmp(line, "AOK", 3) == 0)
+				return LINE_AOK;
+
+			if (strncmp(line, "ERR", 3) == 0)
+				return LINE_ERR;
+
+			if (strncmp(line, "CMD", 3) == 0)
+				return LINE_CMD;
+
+			if (strncmp(line, "Connected", 9) == 0)
+				return LINE_CONNECTED;
+
+			if (strncmp(line, "Connection End", 14) == 0 || strncmp(line, "WV,", 3) == 0 || strncmp(line, "WC,", 3) == 0
+				|| strncmp(line, "Notify,", 7) == 0 || strncmp(line, "Indicate,", 9) == 0)
+				return LINE_EVENT;
+
+			return IsScanLine(line) ? LINE_SCAN : LINE_OTHER;
+		}
+
+		bool RN4020Driver::IsScanLine(const char* line)
 		{
-			const char* ptr = line;
+			// 12 hex chars MAC Address followed by the address type (0 public, 1 random)
+			for (uint8_t i = 0; i < 12; ++i)
+			{
+				if (Util::HexValue(line[i]) < 0)
+					return false;
+			}
+
+			return line[12] == ',' && (line[13] == '0' || line[13] == '1') && line[14] == ',';
+		}
+
+		bool RN4020Driver::ParseScanLine(const char* line, BluetoothLEPeripheral* peripheral)
+		{
+			// MAC Address
+			uint8_t mac[6];
+			if (!Util::DecodeHex(line, mac, sizeof(mac)) || line[12] != ',')
+				return false;
 
-			MACAddress address(ptr);
-			ptr += 13; // skip the MACAddress + ','
+			// address type
+			const char* ptr = line + 13;
+			if ((*ptr != '0' && *ptr != '1') || ptr[1] != ',')
+				return false;
 
-			bool randomAddress = *ptr == 0;
-			ptr += 2; // skip the randomAddress + ','
+			bool randomAddress = *ptr == '1';
+			ptr += 2;
 
-			size_t nameLength = strchr(ptr, ',') - ptr;
-			if (nameLength > 20) // make sure that we can't overflow
-				nameLength = 20;
+			// name (truncated to the maximum of 20 chars)
+			char name[MAX_NAME_LEN + 1] = { 0 };
+			uint8_t nameLength = 0;
+			for (; *ptr != ','; ++ptr)
+			{
+				if (*ptr == '\0')
+					return false;
 
-			char name[21] = { 0 };
-			memcpy(name, ptr, nameLength);
-			ptr += nameLength + 1; // skip the name + ','
+				if (nameLength < MAX_NAME_LEN)
+					name[nameLength++] = *ptr;
+			}
 
-			// todo primary service
+			++ptr;
+
+			// primary service: empty, 16 bit or 128 bit
 			UUID uuid;
-			ptr += 1;
+			uint8_t digits = parseUUID(ptr, &uuid);
+			if (ptr[digits] != ',')
+				return false;
+
+			ptr += digits + 1;
 
-			int8_t rssi;
-			long val = strtol(ptr, NULL, 16);
-			rssi = static_cast<int8_t>(val);
+			// signed hex RSSI
+			bool negative = *ptr == '-';
+			if (negative)
+				++ptr;
 
-			return BluetoothLEPeripheral(address, randomAddress, name, uuid, rssi);
+			uint32_t value;
+			digits = Util::ParseHex(ptr, &value, 2);
+			// -80 is the smallest int8_t, 7F the largest
+			if (digits == 0 || ptr[digits] != '\0' || value > (negative ? 0x80u : 0x7Fu))
+				return false;
+
+			int8_t rssi = static_cast<int8_t>(negative ? -static_cast<int32_t>(value) : value);
+
+			*peripheral = BluetoothLEPeripheral(MACAddress(mac), randomAddress, name, uuid, rssi);
+			return true;
 		}
 
-		void ParseCharacteristic(char** token, UUID* characteristicUUID, uint16_t* handle)
+		const char* ParseCharacteristic(const char* line, UUID* characteristicUUID, uint16_t* handle)
 		{
 			// skip the two spaces
-			*token += 2;
+			const char* ptr = line + 2;
+
+			// first field is characteristic UUID
+			uint8_t digits = parseUUID(ptr, characteristicUUID);
+			if (digits == 0 || ptr[digits] != ',')
+				return NULL;
+
+			ptr += digits + 1;
 
-			// first token is characteristic UUID
-			*token = strtok(*token, ",");
-			*characteristicUUID = UUID(*token);
+			// second field is handle
+			uint32_t value;
+			digits = Util::ParseHex(ptr, &value, 4);
+			if (digits == 0 || ptr[digits] != ',')
+				return NULL;
 
-			// second token is handle
-			*token = strtok(NULL, ",");
-			*handle = static_cast<uint16_t>(strtoul(*token, NULL, 16));
+			*handle = static_cast<uint16_t>(value);
+			return ptr + digits + 1;
 		}
 
 		template <>
-		LongServerCharacteristic ParseCharacteristic<LongServerCharacteristic>(const UUID& serviceUUID, char* line)
+		LongServerCharacteristic ParseCharacteristic<LongServerCharacteristic>(const UUID& serviceUUID, const char* line)
 		{
 			UUID characteristicUUID;
 			uint16_t handle;
-			ParseCharacteristic(&line, &characteristicUUID, &handle);
+			const char* attribute = ParseCharacteristic(line, &characteristicUUID, &handle);
+			if (attribute == NULL)
+				return LongServerCharacteristic();
 
 			// last V if value; C if configuration
-			line = strtok(NULL, ",");
-			bool isConfiguration = line[0] == 'C';
+			bool isConfiguration = attribute[0] == 'C';
 
 			return LongServerCharacteristic(serviceUUID, characteristicUUID, handle, isConfiguration);
 		}
 
 		template <>
-		LongClientCharacteristic ParseCharacteristic<ClientCharacteristic<UUID>>(const UUID& serviceUUID, char* line)
+		LongClientCharacteristic ParseCharacteristic<ClientCharacteristic<UUID>>(const UUID& serviceUUID, const char* line)
 		{
 			UUID characteristicUUID;
 			uint16_t handle;
-			ParseCharacteristic(&line, &characteristicUUID, &handle);
+			const char* attribute = ParseCharacteristic(line, &characteristicUUID, &handle);
+			if (attribute == NULL)
+				return LongClientCharacteristic();
 
 			// last is the property
-			line = strtok(NULL, ",");
-			CharacteristicProperty characteristicProperty = static_cast<CharacteristicProperty>(strtoul(line, NULL, 16));
+			uint32_t property = 0;
+			Util::ParseHex(attribute, &property, 2);
 
-			return LongClientCharacteristic(serviceUUID, characteristicUUID, handle, characteristicProperty);
+			return LongClientCharacteristic(serviceUUID, characteristicUUID, handle, static_cast<CharacteristicProperty>(property));
 		}
 	}
 }
@@ -6,7 +6,22 @@
 #include "../Models/ServerCharacteristic.h"
 #include "../Models/ClientCharacteristic.h"
 #include "../Serial/DelimiterSerial.h"
+#include "../Models/Advertisement.h"
 #include "../Models/ClientCharacteristicConfiguration.h"
+#include "../Models/GattTable.h"
+#include "../Models/ScanFilter.h"
+#include "../Util/Hex.h"
+
+// maximum length of a line copied out of the read ahead buffer, the listings (LS, LC) are
+// parsed in place so their lines with a 128 bit UUID only have to fit in RN4020_RX_BUF_LEN
+#ifndef RN4020_LINE_LEN
+#define RN4020_LINE_LEN 64
+#endif
+
+// size of the read ahead buffer, holds several responses at once (must be a power of two)
+#ifndef RN4020_RX_BUF_LEN
+#define RN4020_RX_BUF_LEN 256
+#endif
 
 namespace Bluetooth
 {
@@ -16,13 +31,17 @@ namespace Bluetooth
 	{
 		extern char g_NewLineDelimiter[];
 
+		class RN4020Pipeline;
+
 		class RN4020Driver
 		{
-			friend class RN4020Device;
+			friend class Bluetooth::RN4020Device;
+			friend class RN4020Pipeline;
 
 		public:
-			enum BaudRate;
-			enum Features;
+			// the underlying types make the forward declarations valid C++11
+			enum BaudRate : uint8_t;
+			enum Features : uint32_t;
 
 			typedef uint32_t Services;
 
@@ -430,6 +449,15 @@ namespace Bluetooth
 			/// 
 			bool Broadcast(uint8_t data[25], uint8_t len) const;
 
+			/// 
+			/// Sets the advertisement content (like Broadcast) from an advertisement encoded once
+			/// (see AdvertisementData), so rotating between advertisements doesn't format them again.
+			///
+			/// @param advertisement	encoded advertisement
+			/// @return	true if operation completed succesfully, false if it is empty
+			/// 
+			bool Broadcast(const Advertisement& advertisement) const;
+
 			/// 
 			/// This command places the module into a Dormant mode that consumes very little
 			/// power, and can be issued by either a central or peripheral device.\n
@@ -455,8 +483,8 @@ namespace Bluetooth
 			///		connected, or “no” if no bonding device\n
 			///		• Server Services : Bitmap of services that are supported in the server role\n\n
 			///
-			/// Note: it flushes the serial after performing the command to make sure it is empty
-			/// for the next command.
+			/// Note: it skips the remaining lines until the module is quiet to make sure the serial is
+			/// empty for the next command.
 			///
 			/// @param buf		Buffer where to dump to
 			/// @param len		Length of the buffer
@@ -521,6 +549,17 @@ namespace Bluetooth
 			/// 
 			bool StopScan() const;
 
+			/// 
+			/// Stops scanning and connects to a scanned device at once: X and E are sent back to
+			/// back, without waiting for the module to acknowledge X first. The advertisements
+			/// still received in between are skipped. Wait for the "Connected" status afterwards.
+			///
+			/// @param usePublicAddress		MAC address type
+			/// @param macAddress			6 - byte MAC adress
+			/// @return	true if both commands were accepted
+			/// 
+			bool StopScanAndEstablish(bool usePublicAddress, const MACAddress& macAddress) const;
+
 			/// 
 			/// This command is only available to a peripheral or broadcaster device. It stops
 			/// advertisement that was started by an “A” command.\n\n
@@ -539,18 +578,118 @@ namespace Bluetooth
 			bool StopConnecting() const;
 
 			/// 
-			/// After issueuing the Find command use this to read the scanned devices. It relies on
-			/// the serial.Read to timeout after a certain time, use the timeout argument to specify
-			/// how many it will be called until it stops trying. For example if the serial timeout
-			/// is 100 ms it blocks up to timeout x 100ms.\n
-			/// It also stops when the len has been reached to indicate the length of the array.
+			/// After issueuing the Find command use this to read the scanned devices. It reads until
+			/// the timeout has passed (regardless of the timeout of the serial) or until the len has
+			/// been reached to indicate the length of the array.
 			///
 			/// @param devices		Scanned devices
 			/// @param len			Maximum length of devices to store
 			/// @param found		Devices found
+			/// @param timeout		Maximum time to scan [ms]
+			/// @param filter		Only stores the devices matching the filter (may be NULL)
+			/// @return	true if operation completed succesfully					
+			/// 
+			bool ReadScan(BluetoothLEPeripheral* devices, uint8_t len, uint8_t* found, uint32_t timeout = 1000, const ScanFilter* filter = NULL) const;
+
+			/// 
+			/// After issueuing the Find command use this to stream the scanned devices. Each
+			/// advertisement is reported to the callback as soon as it is received, until the
+			/// callback returns false or the timeout has passed.
+			///
+			/// @param callback		Called for each advertisement
+			/// @param context		Passed to the callback
+			/// @param timeout		Maximum time to scan [ms]
+			/// @param reported		Amount of advertisements reported (may be NULL)
+			/// @param filter		Only reports the advertisements matching the filter (may be NULL)
 			/// @return	true if operation completed succesfully					
 			/// 
-			bool ReadScan(BluetoothLEPeripheral* devices, uint8_t len, uint8_t* found, uint8_t timeout = 10) const;
+			bool ReadScan(ScanCallback callback, void* context, uint32_t timeout, uint32_t* reported = NULL, const ScanFilter* filter = NULL) const;
+
+			/// 
+			/// After issueuing the Find command use this to pull the scanned devices one by one.
+			/// Other lines received while scanning are skipped, as are the advertisements which
+			/// don't match the filter (checked on the raw line, so these are never parsed).
+			///
+			/// @param peripheral	The scanned device
+			/// @param deadline		Time up to which to wait for an advertisement
+			/// @param filter		Filter of the advertisements (may be NULL)
+			/// @return	true if an advertisement was received before the deadline
+			/// 
+			bool ReadNextScan(BluetoothLEPeripheral* peripheral, const Util::Deadline& deadline, const ScanFilter* filter = NULL) const;
+
+			/// 
+			/// Kind of line sent by the module, see ClassifyLine
+			/// 
+			enum LineType
+			{
+				LINE_AOK,			// the command succeeded
+				LINE_ERR,			// the command failed
+				LINE_CMD,			// booted in command mode
+				LINE_CONNECTED,		// the connection is established
+				LINE_SCAN,			// an advertisement received while scanning
+				LINE_EVENT,			// Connection End, a write by the client (WV, WC) or a notification
+				LINE_OTHER			// e.g. a value, a listing or another status
+			};
+
+			/// 
+			/// Sends a command (command[,param]) with a single vectored write. The driver sends
+			/// all its commands with this, it can be used to talk to the module over another
+			/// (e.g. asynchronous) line serial.
+			///
+			/// @param lines		Serial which appends the delimiter to each send (a DelimiterSerial)
+			/// @param command		Command to send
+			/// @param param		Parameter of the command (may be NULL)
+			/// @return	true if the command was sent
+			/// 
+			static bool SendCommand(const Serial::ISerial& lines, const char* command, const char* param);
+
+			/// 
+			/// Classifies a received line the way the driver matches its responses
+			///
+			/// @param line			Line without the \r\n
+			/// @return	the kind of line
+			/// 
+			static LineType ClassifyLine(const char* line);
+
+			/// 
+			/// Checks if a line starts like a scan result (MAC,type,), use ParseScanLine to
+			/// validate the whole line.
+			///
+			/// @param line			Line without the \r\n
+			/// @return	true if the line looks like a scan result
+			/// 
+			static bool IsScanLine(const char* line);
+
+			/// 
+			/// Parses a line received while scanning (MAC,type,name,uuid,rssi) in a single pass.
+			/// The primary service is either empty, a 16 bit or a 128 bit UUID and the RSSI is a
+			/// signed hex number (e.g. -4B).
+			///
+			/// @param line			Scan line without the \r\n
+			/// @param peripheral	The scanned peripheral
+			/// @return	false if the line isn't a valid scan result
+			/// 
+			static bool ParseScanLine(const char* line, BluetoothLEPeripheral* peripheral);
+
+			/// 
+			/// Requests Server Services (LS command) and parses the whole listing at once into a
+			/// table of all services and characteristics. Prefer this over several ListServer*
+			/// calls, each of these lists everything again.
+			///
+			/// @param table		Table to fill (cleared first)
+			/// @return	true if the complete listing fitted in the table
+			/// 
+			bool DiscoverServer(GattTable* table) const;
+
+			/// 
+			/// Requests Client Services (LC command) and parses the whole listing at once into a
+			/// table of all services and characteristics.\n
+			/// Note: must be connected to a client.
+			///
+			/// @param table		Table to fill (cleared first)
+			/// @return	true if the complete listing fitted in the table
+			/// 
+			bool DiscoverClient(GattTable* table) const;
 
 			/// 
 			/// Requests Server Services (LS command) and stores the UUID of each service in an array.
@@ -711,7 +850,94 @@ namespace Bluetooth
 			template <typename T>
 			bool ReadClientIntegerByHandle(uint16_t handle, T* value) const;
 
-			enum BaudRate
+			/// 
+			/// Writes a value of up to 20 bytes (e.g. several readings packed in one write) to the
+			/// Server Characteristic specified by the UUID. The value is encoded straight from the
+			/// given memory.
+			///
+			/// @param uuid		UUID of characteristic
+			/// @param value	bytes to write
+			/// @param len		amount of bytes (1 up to 20)
+			/// @return	true if operation completed succesfully					
+			/// 
+			bool WriteServerValueByUUID(uint16_t uuid, const uint8_t* value, uint8_t len) const;
+
+			/// 
+			/// Writes a value of up to 20 bytes to the Server Characteristic specified by the handle
+			///
+			/// @param handle	Handle of characteristic
+			/// @param value	bytes to write
+			/// @param len		amount of bytes (1 up to 20)
+			/// @return	true if operation completed succesfully					
+			/// 
+			bool WriteServerValueByHandle(uint16_t handle, const uint8_t* value, uint8_t len) const;
+
+			/// 
+			/// Reads the value of the Server Characteristic specified by the UUID. The value is
+			/// decoded straight into the given memory.
+			///
+			/// @param uuid		UUID of characteristic
+			/// @param value	bytes to read to
+			/// @param len		size of value
+			/// @param read		amount of bytes read (may be NULL)
+			/// @return	true if operation completed succesfully, false if the value doesn't fit
+			/// 
+			bool ReadServerValueByUUID(uint16_t uuid, uint8_t* value, uint8_t len, uint8_t* read = NULL) const;
+
+			/// 
+			/// Reads the value of the Server Characteristic specified by the handle
+			///
+			/// @param handle	Handle of characteristic
+			/// @param value	bytes to read to
+			/// @param len		size of value
+			/// @param read		amount of bytes read (may be NULL)
+			/// @return	true if operation completed succesfully, false if the value doesn't fit
+			/// 
+			bool ReadServerValueByHandle(uint16_t handle, uint8_t* value, uint8_t len, uint8_t* read = NULL) const;
+
+			/// 
+			/// Writes a value of up to 20 bytes to the Client Characteristic specified by the UUID
+			///
+			/// @param uuid		UUID of characteristic
+			/// @param value	bytes to write
+			/// @param len		amount of bytes (1 up to 20)
+			/// @return	true if operation completed succesfully					
+			/// 
+			bool WriteClientValueByUUID(uint16_t uuid, const uint8_t* value, uint8_t len) const;
+
+			/// 
+			/// Writes a value of up to 20 bytes to the Client Characteristic specified by the handle
+			///
+			/// @param handle	Handle of characteristic
+			/// @param value	bytes to write
+			/// @param len		amount of bytes (1 up to 20)
+			/// @return	true if operation completed succesfully					
+			/// 
+			bool WriteClientValueByHandle(uint16_t handle, const uint8_t* value, uint8_t len) const;
+
+			/// 
+			/// Reads the value of the Client Characteristic specified by the UUID
+			///
+			/// @param uuid		UUID of characteristic
+			/// @param value	bytes to read to
+			/// @param len		size of value
+			/// @param read		amount of bytes read (may be NULL)
+			/// @return	true if operation completed succesfully, false if the value doesn't fit
+			/// 
+			bool ReadClientValueByUUID(uint16_t uuid, uint8_t* value, uint8_t len, uint8_t* read = NULL) const;
+
+			/// 
+			/// Reads the value of the Client Characteristic specified by the handle
+			///
+			/// @param handle	Handle of characteristic
+			/// @param value	bytes to read to
+			/// @param len		size of value
+			/// @param read		amount of bytes read (may be NULL)
+			/// @return	true if operation completed succesfully, false if the value doesn't fit
+			/// 
+			bool ReadClientValueByHandle(uint16_t handle, uint8_t* value, uint8_t len, uint8_t* read = NULL) const;
+
+			enum BaudRate : uint8_t
 			{
 				RN4020_BAUD_2400 = 0,
 				RN4020_BAUD_9600 = 1,
@@ -723,7 +949,7 @@ namespace Bluetooth
 				RN4020_BAUD_921600 = 7
 			};
 
-			enum Features
+			enum Features : uint32_t
 			{
 				/// 
 				/// If set, the device that starts the connection is central. If cleared, the device that
@@ -855,11 +1081,37 @@ namespace Bluetooth
 			};
 
 		private:
-			static const uint8_t BUF_LEN = 32;
+			static const uint8_t BUF_LEN = RN4020_LINE_LEN;
+
+			// read ahead buffer, holds several responses (a scan or listing burst) at once
+			static const uint16_t RX_BUF_LEN = RN4020_RX_BUF_LEN;
+
+			// a line is received in place, so it must fit in the read ahead buffer
+			typedef int assert_line_fits_in_RX_BUF_LEN[(RX_BUF_LEN > BUF_LEN) ? 1 : -1];
 
+			// bytes of a characteristic value
+			static const uint8_t MAX_VALUE_LEN = 20;
+
+			// param + , + value + 0
+			static const uint8_t VALUE_PARAM_LEN = 4 + 1 + 2 * MAX_VALUE_LEN + 1;
+
+			bool Send(const char* command, const char* param) const;
 			bool Set(const char* command, const char* param) const;
 			bool SetHex32(const char* command, uint32_t value) const;
 
+			template <typename T>
+			static void FormatCharacteristicInteger(char* buf, uint8_t len, uint16_t handle, T value);
+
+			// "a,b" or "a,b,c" as 4 digit hex (e.g. the interval and window of A and F), buf must
+			// hold 10 or 15 chars
+			static void FormatHex16List(char* buf, uint16_t a, uint16_t b, const uint16_t* c);
+
+			// "command,handle" (command of at most 4 chars), buf must hold 10 chars
+			static void FormatCommandHandle(char* buf, const char* command, uint16_t handle);
+
+			// "param,value" as hex, buf must hold VALUE_PARAM_LEN chars, false if len is invalid
+			static bool FormatCharacteristicValue(char* buf, uint16_t param, const uint8_t* value, uint8_t len);
+
 			template <typename T>
 			bool WriteCharacteristicInteger(const char* command, uint16_t handle, T value) const;
 
@@ -869,43 +1121,77 @@ namespace Bluetooth
 			template <typename T>
 			bool ReadServerCharacteristicInteger(const char* command, uint16_t param, T* value) const;
 
+			bool WriteCharacteristicValue(const char* command, uint16_t param, const uint8_t* value, uint8_t len) const;
+
+			// the client returns R,value. and the server only the value
+			bool ReadCharacteristicValue(const char* command, uint16_t param, bool isClient, uint8_t* value, uint8_t len, uint8_t* read) const;
+
 			bool Get(char* buf, uint32_t len, int32_t* received = NULL) const;
 			bool Get(const char* command, char* buf, uint32_t len, int32_t* received = NULL) const;
 			bool GetHex32(const char* command, uint32_t* value) const;
 
-			bool WaitAnything(uint8_t timeout = 20) const;
-			bool WaitAnything(char* buf, uint32_t len, int32_t* received = NULL, uint8_t timeout = 20) const;
+			// receives the line without copying it, valid up to the next receive
+			bool GetInPlace(const char* command, const char** line) const;
+
+			// skips lines (e.g. advertisements) up to the AOK or ERR status
+			bool SkipToStatus(const Util::Deadline& deadline) const;
+
+			// waits up to timeout [ms] for a non empty line
+			bool WaitAnything(uint32_t timeout = 2000) const;
+			bool WaitAnything(char* buf, uint32_t len, int32_t* received = NULL, uint32_t timeout = 2000) const;
 
 			bool ListServices(const char* command, UUID* services, uint8_t len, uint8_t* listed) const;
+			bool Discover(const char* command, GattTable* table) const;
 
 			template <typename T>
 			bool ListCharacteristics(const UUID* targetUUID, const char* command, T* characteristics, uint8_t len, uint8_t* listed) const;
 
-			BluetoothLEPeripheral ParseScanLine(const char* line) const;
-			Serial::DelimiterSerial<uint8_t, BUF_LEN, g_NewLineDelimiter> m_Serial;
+			Serial::DelimiterSerial<uint16_t, RX_BUF_LEN, g_NewLineDelimiter> m_Serial;
 		};
 
 		template <typename T>
-		T ParseCharacteristic(const UUID& serviceUUID, char* line)
+		T ParseCharacteristic(const UUID& serviceUUID, const char* line)
 		{
-			typedef int assert_no_generic_implementation[-1];
+			// depends on T, so it only fails when instantiated
+			static_assert(sizeof(T) == 0, "no generic implementation");
 			return NULL;
 		}
 
-		void ParseCharacteristic(char** token, UUID* characteristicUUID, uint16_t* handle);
+		// parses "  UUID,handle," of a listed characteristic, returns the remainder (V/C or the property), NULL if invalid
+		const char* ParseCharacteristic(const char* line, UUID* characteristicUUID, uint16_t* handle);
 
 		template <>
-		LongServerCharacteristic ParseCharacteristic<LongServerCharacteristic>(const UUID& serviceUUID, char* line);
+		LongServerCharacteristic ParseCharacteristic<LongServerCharacteristic>(const UUID& serviceUUID, const char* line);
 
 		template <>
-		LongClientCharacteristic ParseCharacteristic<LongClientCharacteristic>(const UUID& serviceUUID, char* line);
+		LongClientCharacteristic ParseCharacteristic<LongClientCharacteristic>(const UUID& serviceUUID, const char* line);
+
+		template <typename T>
+		void RN4020Driver::FormatCharacteristicInteger(char* buf, uint8_t len, uint16_t handle, T value)
+		{
+			// the value is encoded from 32 bits
+			static_assert(sizeof(T) <= 4, "T is at most 32 bits");
+
+			// handle + , + T + 0
+			if (len < 4 + 1 + 2 * sizeof(T) + 1)
+			{
+				if (len > 0)
+					buf[0] = '\0';
+
+				return;
+			}
+
+			char* ptr = Util::EncodeHex(handle, 4, buf);
+			*ptr++ = ',';
+			*Util::EncodeHex(static_cast<uint32_t>(value), 2 * sizeof(T), ptr) = '\0';
+		}
 
 		template <typename T>
 		bool RN4020Driver::WriteCharacteristicInteger(const char* command, uint16_t handle, T value) const
 		{
 			// handle + T + 0
 			char buf[4 + 2 * sizeof(T) + 2] = { 0 };
-			snprintf(buf, sizeof(buf), "%04X,%0*X", handle, sizeof(T) * 2, value);
+			FormatCharacteristicInteger(buf, sizeof(buf), handle, value);
 
 			return Set(command, buf);
 		}
@@ -915,7 +1201,7 @@ namespace Bluetooth
 		{
 			// uint32_t is max 8 bytes + R + , + .
 			char buf[12] = { 0 };
-			snprintf(buf, sizeof(buf), "%.4s,%04X", command, param);
+			FormatCommandHandle(buf, command, param);
 
 			if (!Get(buf, buf, sizeof(buf)))
 				return false;
@@ -937,8 +1223,8 @@ namespace Bluetooth
 		bool RN4020Driver::ReadServerCharacteristicInteger(const char* command, uint16_t param, T* value) const
 		{
 			// max command lenght is 4 CUWC/CUWV + param + 0
-			char buf[9] = { 0 };
-			snprintf(buf, sizeof(buf), "%.4s,%04X", command, param);
+			char buf[10] = { 0 };
+			FormatCommandHandle(buf, command, param);
 
 			// largest integer returned is 32 bits
 			uint32_t x;
@@ -952,12 +1238,12 @@ namespace Bluetooth
 		template <typename T>
 		bool RN4020Driver::ListCharacteristics(const UUID* targetUUID, const char* command, T* characteristics, uint8_t len, uint8_t* listed) const
 		{
-			char line[BUF_LEN];
+			const char* line;
 
 			UUID serviceUUID;
 			uint8_t index = 0;
 
-			bool receiving = Get(command, line, sizeof(line));
+			bool receiving = GetInPlace(command, &line);
 			bool isTargetUUID = false;
 
 			while (receiving && index < len && strncmp(line, "END", 3) != 0)
@@ -979,12 +1265,15 @@ namespace Bluetooth
 					isTargetUUID = targetUUID && *targetUUID == serviceUUID;
 				}
 
-				receiving = Get(line, sizeof(line));
+				receiving = GetInPlace(NULL, &line);
 			}
 
 			if (listed)
 				*listed = index;
 
+			// make sure the rest of the listing is dropped on early exit
+			m_Serial.Flush();
+
 			// true if we requested everything or got the target characteristics
 			return targetUUID == NULL || isTargetUUID;
 		}
@@ -0,0 +1,201 @@
+#include "RN4020EventDispatcher.h"
+
+// std libraries
+#include <chrono>
+#include <string.h>
+
+namespace
+{
+	bool startsWith(const char* line, const char* prefix)
+	{
+		return strncmp(line, prefix, strlen(prefix)) == 0;
+	}
+}
+
+namespace Bluetooth
+{
+	namespace Drivers
+	{
+		RN4020EventDispatcher::RN4020EventDispatcher(const Serial::ISerial& serial)
+			: m_Serial(serial),
+			  m_Lines(serial),
+			  m_ResponseTimeout(100),
+			  m_Running(false),
+			  m_Failed(false)
+		{
+			memset(m_Handlers, 0, sizeof(m_Handlers));
+		}
+
+		RN4020EventDispatcher::~RN4020EventDispatcher()
+		{
+			Stop();
+		}
+
+		bool RN4020EventDispatcher::Start()
+		{
+			if (m_Thread.joinable())
+				return false;
+
+			m_Running = true;
+			m_Failed = false;
+			m_Thread = std::thread(&RN4020EventDispatcher::Read, this);
+
+			return true;
+		}
+
+		void RN4020EventDispatcher::Stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Running = false;
+			}
+
+			if (m_Thread.joinable())
+				m_Thread.join();
+		}
+
+		void RN4020EventDispatcher::SetHandler(EventType type, EventHandler handler, void* context)
+		{
+			if (type <= EVENT_NONE || type >= EVENT_COUNT)
+				return;
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Handlers[type].Callback = handler;
+			m_Handlers[type].Context = context;
+		}
+
+		RN4020EventDispatcher::EventType RN4020EventDispatcher::Classify(const char* line)
+		{
+			if (strcmp(line, "Connected") == 0)
+				return EVENT_CONNECTED;
+			if (strcmp(line, "Connection End") == 0)
+				return EVENT_CONNECTION_END;
+			if (startsWith(line, "WV,"))
+				return EVENT_SERVER_WRITE;
+			if (startsWith(line, "WC,"))
+				return EVENT_SERVER_CONFIGURATION;
+			if (startsWith(line, "Notify,"))
+				return EVENT_NOTIFY;
+			if (startsWith(line, "Indicate,"))
+				return EVENT_INDICATE;
+			if (RN4020Driver::IsScanLine(line))
+				return EVENT_SCAN;
+
+			return EVENT_NONE;
+		}
+
+		int32_t RN4020EventDispatcher::Send(const char* buffer, uint32_t len) const
+		{
+			return m_Serial.Send(buffer, len);
+		}
+
+		int32_t RN4020EventDispatcher::SendVector(const Serial::SerialBuffer* buffers, uint8_t count) const
+		{
+			return m_Serial.SendVector(buffers, count);
+		}
+
+		int32_t RN4020EventDispatcher::Receive(char* buffer, uint32_t len) const
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+
+			m_Received.wait_for(lock, std::chrono::milliseconds(m_ResponseTimeout), [this]
+			{
+				return m_Responses.GetCount() > 0 || m_Failed;
+			});
+
+			return Load(buffer, len);
+		}
+
+		int32_t RN4020EventDispatcher::ReceiveUntil(char* buffer, uint32_t len, const Util::Deadline& deadline) const
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+
+			m_Received.wait_until(lock, deadline.GetExpiry(), [this]
+			{
+				return m_Responses.GetCount() > 0 || m_Failed;
+			});
+
+			return Load(buffer, len);
+		}
+
+		void RN4020EventDispatcher::Flush() const
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Responses.Flush();
+		}
+
+		int32_t RN4020EventDispatcher::Load(char* buffer, uint32_t len) const
+		{
+			// called with the lock held
+			if (m_Responses.GetCount() == 0)
+				return m_Failed ? -1 : 0;
+
+			uint16_t chunk = len > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(len);
+			return m_Responses.Load(buffer, chunk);
+		}
+
+		void RN4020EventDispatcher::Read()
+		{
+			char line[LINE_LEN];
+			while (true)
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					if (!m_Running)
+						break;
+				}
+
+				uint32_t overflows = m_Lines.GetOverflows();
+				int32_t received = m_Lines.Receive(line, sizeof(line));
+
+				// garbage (e.g. line noise or a wrong baud rate) without a delimiter overflowed
+				// the line buffer, it has been dropped and the port still works
+				if (received == -1 && m_Lines.GetOverflows() != overflows)
+					continue;
+
+				if (received == -1)
+				{
+					// the serial failed, wake up the waiting caller
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					m_Failed = true;
+					m_Received.notify_all();
+					break;
+				}
+
+				// nothing received (timed out) or an empty line
+				if (received == 0)
+					continue;
+
+				Dispatch(line, static_cast<uint16_t>(received));
+			}
+		}
+
+		void RN4020EventDispatcher::Dispatch(const char* line, uint16_t len)
+		{
+			EventType type = Classify(line);
+
+			if (type != EVENT_NONE)
+			{
+				Handler handler;
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					handler = m_Handlers[type];
+				}
+
+				// call it without holding the lock, so the handler doesn't block Receive
+				if (handler.Callback && handler.Callback(handler.Context, type, line))
+					return;
+			}
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			// drop the complete line if it doesn't fit, a partial line would break the framing
+			if (m_Responses.GetFree() < len + 2)
+				return;
+
+			m_Responses.Store(line, len);
+			m_Responses.Store(g_NewLineDelimiter, 2);
+			m_Received.notify_all();
+		}
+	}
+}
@@ -0,0 +1,199 @@
+#ifndef RN4020_EVENT_DISPATCHER_H_
+#define RN4020_EVENT_DISPATCHER_H_
+
+#include "RN4020Driver.h"
+#include "../Serial/ISerial.h"
+#include "../Serial/DelimiterSerial.h"
+#include "../Util/CircularBuffer.h"
+
+// std libraries
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Bluetooth
+{
+	namespace Drivers
+	{
+		///
+		/// Reads the output of the RN4020 on a background thread and seperates the unsolicited
+		/// events (connection status, writes and notifications from the peer, scan results) from
+		/// the command responses. Events are dispatched to the registered handlers as soon as
+		/// they are received, the command responses are handed out by Receive. \n
+		/// The dispatcher is a serial itself, so the driver is constructed on top of it:
+		/// \code
+		/// RN4020EventDispatcher dispatcher(port);
+		/// dispatcher.SetHandler(RN4020EventDispatcher::EVENT_SERVER_WRITE, onWrite, &context);
+		/// dispatcher.Start();
+		/// RN4020Device device(dispatcher);
+		/// \endcode
+		/// Handlers are called on the reader thread, they should return quickly and may not use
+		/// the driver themselves.
+		///
+		class RN4020EventDispatcher : public Serial::ISerial
+		{
+		public:
+			enum EventType
+			{
+				///
+				/// Not an event, the line is a command response
+				///
+				EVENT_NONE = -1,
+
+				///
+				/// Connected, a connection with a peer has been established
+				///
+				EVENT_CONNECTED,
+
+				///
+				/// Connection End, the connection has been terminated
+				///
+				EVENT_CONNECTION_END,
+
+				///
+				/// WV,handle,value. the peer wrote a server characteristic
+				///
+				EVENT_SERVER_WRITE,
+
+				///
+				/// WC,handle,value. the peer wrote a client characteristic configuration
+				///
+				EVENT_SERVER_CONFIGURATION,
+
+				///
+				/// Notify,handle,value. the peer notified a client characteristic
+				///
+				EVENT_NOTIFY,
+
+				///
+				/// Indicate,handle,value. the peer indicated a client characteristic
+				///
+				EVENT_INDICATE,
+
+				///
+				/// MAC,type,name,uuid,rssi result of a scan
+				///
+				EVENT_SCAN,
+
+				EVENT_COUNT
+			};
+
+			///
+			/// Called on the reader thread for a received event
+			///
+			/// @param context		Context passed with SetHandler
+			/// @param type			Type of the event
+			/// @param line			The received line (without \r\n)
+			/// @return				true if the event is consumed, false to also hand it out as
+			///						response (e.g. to let Connect see the Connected status)
+			///
+			typedef bool (*EventHandler)(void* context, EventType type, const char* line);
+
+			///
+			/// Constructs a dispatcher around the serial, the reader thread isn't started yet
+			///
+			/// @param serial		Serial connected to the RN4020, its Receive should time out
+			///						so the reader thread can be stopped
+			///
+			explicit RN4020EventDispatcher(const Serial::ISerial& serial);
+			~RN4020EventDispatcher();
+
+			///
+			/// Starts the reader thread
+			///
+			/// @return				true if operation completed succesfully
+			///
+			bool Start();
+
+			///
+			/// Stops the reader thread, waits until the pending Receive of the serial returned
+			///
+			void Stop();
+
+			///
+			/// Sets the handler of an event type, events without a handler are handed out as
+			/// responses (as if there is no dispatcher).
+			///
+			/// @param type			Type of the event
+			/// @param handler		Handler to call (NULL removes the handler)
+			/// @param context		Passed to the handler
+			///
+			void SetHandler(EventType type, EventHandler handler, void* context = NULL);
+
+			///
+			/// Sets the maximum time Receive waits for a response
+			///
+			/// @param timeout		Timeout [ms]
+			///
+			void SetResponseTimeout(uint32_t timeout)
+			{
+				m_ResponseTimeout = timeout;
+			}
+
+			///
+			/// Classifies a received line
+			///
+			/// @param line			Line without the \r\n
+			/// @return				type of the event, EVENT_NONE for a command response
+			///
+			static EventType Classify(const char* line);
+
+			int32_t Send(const char* buffer, uint32_t len) const override;
+			int32_t SendVector(const Serial::SerialBuffer* buffers, uint8_t count) const override;
+
+			///
+			/// Receives the command responses (including their \r\n), waits up to the response
+			/// timeout if none is available.
+			///
+			/// @param buffer		Buffer to store the data
+			/// @param len			Length of the buffer
+			/// @return				-1 if the reader failed, 0 if nothing was received, else the amount of bytes
+			///
+			int32_t Receive(char* buffer, uint32_t len) const override;
+
+			///
+			/// Receives the command responses, waits until the deadline if none is available
+			///
+			/// @param buffer		Buffer to store the data
+			/// @param len			Length of the buffer
+			/// @param deadline		Time up to which to wait
+			/// @return				-1 if the reader failed, 0 if nothing was received, else the amount of bytes
+			///
+			int32_t ReceiveUntil(char* buffer, uint32_t len, const Util::Deadline& deadline) const override;
+
+			///
+			/// Drops the received responses. Events are not affected, they are already dispatched.
+			///
+			void Flush() const override;
+
+		private:
+			static const uint16_t LINE_LEN = 128;
+			static const uint16_t RESPONSE_LEN = 512;
+
+			struct Handler
+			{
+				EventHandler Callback;
+				void* Context;
+			};
+
+			const Serial::ISerial& m_Serial;
+			Serial::DelimiterSerial<uint16_t, 256, g_NewLineDelimiter> m_Lines;
+
+			mutable std::mutex m_Mutex;
+			mutable std::condition_variable m_Received;
+			mutable Util::CircularBuffer<uint16_t, RESPONSE_LEN> m_Responses;
+			Handler m_Handlers[EVENT_COUNT];
+			uint32_t m_ResponseTimeout;
+
+			std::thread m_Thread;
+			bool m_Running;
+			bool m_Failed;
+
+			void Read();
+			int32_t Load(char* buffer, uint32_t len) const;
+			void Dispatch(const char* line, uint16_t len);
+		};
+	}
+}
+
+#endif // !RN4020_EVENT_DISPATCHER_H_
@@ -0,0 +1,190 @@
+#include "RN4020Pipeline.h"
+
+#define RESPONSE_TIMEOUT 1000 // ms
+
+namespace Bluetooth
+{
+	namespace Drivers
+	{
+		RN4020Pipeline::RN4020Pipeline(const RN4020Driver& driver, uint8_t depth)
+			: m_Driver(driver),
+			  m_Depth(depth == 0 || depth > MAX_DEPTH ? MAX_DEPTH : depth),
+			  m_Head(0),
+			  m_Count(0),
+			  m_Failed(0),
+			  m_Timeout(RESPONSE_TIMEOUT)
+		{
+		}
+
+		bool RN4020Pipeline::Set(const char* command, const char* param, Completion completion, void* context)
+		{
+			return Queue(command, param, RESPONSE_STATUS, completion, context);
+		}
+
+		bool RN4020Pipeline::SetHex32(const char* command, uint32_t value, Completion completion, void* context)
+		{
+			char buf[10] = { 0 };
+			Util::EncodeHex(value, 8, buf);
+
+			return Queue(command, buf, RESPONSE_STATUS, completion, context);
+		}
+
+		bool RN4020Pipeline::Get(const char* command, Completion completion, void* context)
+		{
+			return Queue(command, NULL, RESPONSE_VALUE, completion, context);
+		}
+
+		bool RN4020Pipeline::WriteServerValueByHandle(uint16_t handle, const uint8_t* value, uint8_t len, Completion completion, void* context)
+		{
+			char buf[RN4020Driver::VALUE_PARAM_LEN];
+			if (!RN4020Driver::FormatCharacteristicValue(buf, handle, value, len))
+				return false;
+
+			return Queue("SHW", buf, RESPONSE_STATUS, completion, context);
+		}
+
+		bool RN4020Pipeline::WriteClientValueByHandle(uint16_t handle, const uint8_t* value, uint8_t len, Completion completion, void* context)
+		{
+			char buf[RN4020Driver::VALUE_PARAM_LEN];
+			if (!RN4020Driver::FormatCharacteristicValue(buf, handle, value, len))
+				return false;
+
+			return Queue("CHW", buf, RESPONSE_STATUS, completion, context);
+		}
+
+		bool RN4020Pipeline::Broadcast(const Advertisement& advertisement, Completion completion, void* context)
+		{
+			if (advertisement.IsEmpty())
+				return false;
+
+			return Queue("N", advertisement.GetHex(), RESPONSE_STATUS, completion, context);
+		}
+
+		bool RN4020Pipeline::Advertise(uint16_t interval, uint16_t window, Completion completion, void* context)
+		{
+			if (interval == 0 && window == 0)
+				return Queue("A", NULL, RESPONSE_STATUS, completion, context);
+
+			char buf[11] = { 0 };
+			RN4020Driver::FormatHex16List(buf, interval, window, NULL);
+
+			return Queue("A", buf, RESPONSE_STATUS, completion, context);
+		}
+
+		bool RN4020Pipeline::StopAdvertisement(Completion completion, void* context)
+		{
+			return Queue("Y", NULL, RESPONSE_STATUS, completion, context);
+		}
+
+		bool RN4020Pipeline::Complete()
+		{
+			if (m_Count == 0)
+				return false;
+
+			// waiting up to its own deadline always completes the oldest command
+			bool success = false;
+			TryComplete(Util::Deadline(m_Pending[m_Head].Expiry), &success);
+
+			return success;
+		}
+
+		uint8_t RN4020Pipeline::Poll()
+		{
+			// a deadline which has already passed only takes what has been received
+			Util::Deadline now(0);
+
+			uint8_t completed = 0;
+			bool success;
+			while (m_Count > 0 && TryComplete(now, &success))
+				++completed;
+
+			return completed;
+		}
+
+		bool RN4020Pipeline::Drain()
+		{
+			while (m_Count > 0)
+				Complete();
+
+			bool success = m_Failed == 0;
+			m_Failed = 0;
+
+			return success;
+		}
+
+		bool RN4020Pipeline::Queue(const char* command, const char* param, ResponseType type, Completion completion, void* context)
+		{
+			// make room by waiting for the oldest response
+			if (m_Count == m_Depth)
+				Complete();
+
+			if (!m_Driver.Send(command, param))
+				return false;
+
+			Pending& pending = m_Pending[(m_Head + m_Count) % MAX_DEPTH];
+			pending.Type = type;
+			pending.Callback = completion;
+			pending.Context = context;
+			pending.Expiry = Util::Deadline(m_Timeout).GetExpiry();
+
+			++m_Count;
+			return true;
+		}
+
+		bool RN4020Pipeline::TryComplete(const Util::Deadline& deadline, bool* success)
+		{
+			// the line is received in place, so a value of any length up to the receive buffer fits
+			const char* line;
+			int32_t received;
+			while ((received = m_Driver.m_Serial.ReceiveInPlaceUntil(&line, deadline)) > 0)
+			{
+				RN4020Driver::LineType type = RN4020Driver::ClassifyLine(line);
+				if (type == RN4020Driver::LINE_ERR)
+				{
+					*success = Finish(false, line);
+					return true;
+				}
+
+				// a value is any line which isn't a status, an event or a scan result
+				RN4020Driver::LineType expected = m_Pending[m_Head].Type == RESPONSE_VALUE ? RN4020Driver::LINE_OTHER : RN4020Driver::LINE_AOK;
+				if (type == expected)
+				{
+					*success = Finish(true, line);
+					return true;
+				}
+
+				// not the response we are waiting for (e.g. a scan result), keep waiting
+			}
+
+			// nothing received yet, the command may still be answered in time
+			if (received == 0 && !Util::Deadline(m_Pending[m_Head].Expiry).IsExpired())
+				return false;
+
+			// the response is late or a line didn't fit (which also dropped the buffered
+			// responses). The module answers in order, so the responses still coming can't be
+			// matched anymore: fail everything outstanding and start over.
+			while (m_Count > 0)
+				Finish(false, "");
+
+			m_Driver.m_Serial.Flush();
+
+			*success = false;
+			return true;
+		}
+
+		bool RN4020Pipeline::Finish(bool success, const char* response)
+		{
+			Pending pending = m_Pending[m_Head];
+			m_Head = (m_Head + 1) % MAX_DEPTH;
+			--m_Count;
+
+			if (!success)
+				++m_Failed;
+
+			if (pending.Callback)
+				pending.Callback(pending.Context, success, response);
+
+			return success;
+		}
+	}
+}
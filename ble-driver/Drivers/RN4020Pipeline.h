@@ -0,0 +1,261 @@
+#ifndef RN4020_PIPELINE_H_
+#define RN4020_PIPELINE_H_
+
+#include "RN4020Driver.h"
+
+namespace Bluetooth
+{
+	namespace Drivers
+	{
+		///
+		/// Sends commands to the RN4020 without waiting for each response. The module answers
+		/// the commands in the order they were received, so the responses are matched with the
+		/// queued commands in order. This makes a burst of settings or characteristic writes
+		/// bandwidth bound instead of round trip bound. \n
+		/// The pipeline uses the serial of the driver, the driver (and other pipelines) may not be
+		/// used while commands are outstanding.
+		///
+		class RN4020Pipeline
+		{
+		public:
+			///
+			/// Expected response of a queued command
+			///
+			enum ResponseType
+			{
+				///
+				/// AOK or ERR, other lines (e.g. scan results or status) are skipped
+				///
+				RESPONSE_STATUS,
+
+				///
+				/// A single line with the value, ERR means failure. Status lines (AOK, CMD), events
+				/// and scan results received in between are skipped.
+				///
+				RESPONSE_VALUE
+			};
+
+			///
+			/// Called when the response of a command has been received
+			///
+			/// @param context		Context passed with the command
+			/// @param success		true if the command completed succesfully
+			/// @param response		The received line (empty if nothing was received), only valid during the call
+			///
+			typedef void (*Completion)(void* context, bool success, const char* response);
+
+			static const uint8_t MAX_DEPTH = 8;
+
+			///
+			/// Constructs a pipeline on top of the driver
+			///
+			/// @param driver		Driver to send the commands with
+			/// @param depth		Maximum amount of outstanding commands (1 up to MAX_DEPTH)
+			///
+			explicit RN4020Pipeline(const RN4020Driver& driver, uint8_t depth = MAX_DEPTH);
+
+			///
+			/// Queues a set command (command[,param]) expecting AOK. When the pipeline is full
+			/// the oldest response is completed first.
+			///
+			/// @param command		Command to send
+			/// @param param		Parameter of the command (may be NULL)
+			/// @param completion	Called with the result (may be NULL)
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			bool Set(const char* command, const char* param, Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Queues a set command with a 32 bit hex parameter (e.g. SR)
+			///
+			/// @param command		Command to send
+			/// @param value		Value to send as 8 hex characters
+			/// @param completion	Called with the result (may be NULL)
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			bool SetHex32(const char* command, uint32_t value, Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Queues a command which answers with a value (e.g. GN or SHR,001B)
+			///
+			/// @param command		Command to send
+			/// @param completion	Called with the value
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			bool Get(const char* command, Completion completion, void* context = NULL);
+
+			///
+			/// Queues a write of an integer to the server characteristic with the handle
+			///
+			/// @tparam T			Type of integer
+			/// @param handle		Handle of characteristic
+			/// @param value		Value to write
+			/// @param completion	Called with the result (may be NULL)
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			template <typename T>
+			bool WriteServerIntegerByHandle(uint16_t handle, T value, Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Queues a write of an integer to the client characteristic with the handle
+			///
+			/// @tparam T			Type of integer
+			/// @param handle		Handle of characteristic
+			/// @param value		Value to write
+			/// @param completion	Called with the result (may be NULL)
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			template <typename T>
+			bool WriteClientIntegerByHandle(uint16_t handle, T value, Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Queues a write of a value of up to 20 bytes to the server characteristic with the
+			/// handle, e.g. to stream packed readings at the connection rate
+			///
+			/// @param handle		Handle of characteristic
+			/// @param value		Bytes to write (encoded before returning)
+			/// @param len			Amount of bytes (1 up to 20)
+			/// @param completion	Called with the result (may be NULL)
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			bool WriteServerValueByHandle(uint16_t handle, const uint8_t* value, uint8_t len, Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Queues a write of a value of up to 20 bytes to the client characteristic with the
+			/// handle
+			///
+			/// @param handle		Handle of characteristic
+			/// @param value		Bytes to write (encoded before returning)
+			/// @param len			Amount of bytes (1 up to 20)
+			/// @param completion	Called with the result (may be NULL)
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			bool WriteClientValueByHandle(uint16_t handle, const uint8_t* value, uint8_t len, Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Queues setting the advertisement content (like RN4020Driver::Broadcast)
+			///
+			/// @param advertisement	Encoded advertisement (see AdvertisementData)
+			/// @param completion		Called with the result (may be NULL)
+			/// @param context			Passed to the completion
+			/// @return					true if the command was sent, false if it is empty
+			///
+			bool Broadcast(const Advertisement& advertisement, Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Queues starting the advertisement (like RN4020Driver::Advertise)
+			///
+			/// @param interval		Interval between advertisements [ms] (0 with window 0 for the default)
+			/// @param window		Total time to advertise, must be larger than interval [ms]
+			/// @param completion	Called with the result (may be NULL)
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			bool Advertise(uint16_t interval, uint16_t window, Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Queues stopping the advertisement (like RN4020Driver::StopAdvertisement)
+			///
+			/// @param completion	Called with the result (may be NULL)
+			/// @param context		Passed to the completion
+			/// @return				true if the command was sent
+			///
+			bool StopAdvertisement(Completion completion = NULL, void* context = NULL);
+
+			///
+			/// Receives the response of the oldest outstanding command and calls its completion.
+			/// Each command may take up to the response timeout from the moment it was queued.
+			/// If nothing is received in time, or a line is too long for the receive buffer (so
+			/// a value is never reported truncated), all outstanding commands fail and the serial
+			/// is flushed, because later responses can't be matched anymore.
+			///
+			/// @return				true if the oldest command completed succesfully
+			///
+			bool Complete();
+
+			///
+			/// Completes the outstanding commands whose responses have already been received
+			/// (and the ones past their deadline) without waiting
+			///
+			/// @return				amount of completed commands
+			///
+			uint8_t Poll();
+
+			///
+			/// Completes all outstanding commands
+			///
+			/// @return				true if no command failed since the last Drain
+			///
+			bool Drain();
+
+			///
+			/// Sets the time a command may take to be answered, counted from the moment it is
+			/// queued. Applies to commands queued afterwards.
+			///
+			/// @param timeout		Timeout [ms]
+			///
+			void SetResponseTimeout(uint32_t timeout)
+			{
+				m_Timeout = timeout;
+			}
+
+			uint8_t GetOutstanding() const
+			{
+				return m_Count;
+			}
+
+			uint16_t GetFailed() const
+			{
+				return m_Failed;
+			}
+
+		private:
+			struct Pending
+			{
+				ResponseType Type;
+				Completion Callback;
+				void* Context;
+				Util::Deadline::Clock::time_point Expiry;
+			};
+
+			const RN4020Driver& m_Driver;
+			uint8_t m_Depth;
+			uint8_t m_Head;
+			uint8_t m_Count;
+			uint16_t m_Failed;
+			uint32_t m_Timeout;
+			Pending m_Pending[MAX_DEPTH];
+
+			bool Queue(const char* command, const char* param, ResponseType type, Completion completion, void* context);
+			bool Finish(bool success, const char* response);
+			bool TryComplete(const Util::Deadline& deadline, bool* success);
+		};
+
+		template <typename T>
+		bool RN4020Pipeline::WriteServerIntegerByHandle(uint16_t handle, T value, Completion completion, void* context)
+		{
+			char buf[4 + 2 * sizeof(T) + 2] = { 0 };
+			RN4020Driver::FormatCharacteristicInteger(buf, sizeof(buf), handle, value);
+
+			return Queue("SHW", buf, RESPONSE_STATUS, completion, context);
+		}
+
+		template <typename T>
+		bool RN4020Pipeline::WriteClientIntegerByHandle(uint16_t handle, T value, Completion completion, void* context)
+		{
+			char buf[4 + 2 * sizeof(T) + 2] = { 0 };
+			RN4020Driver::FormatCharacteristicInteger(buf, sizeof(buf), handle, value);
+
+			return Queue("CHW", buf, RESPONSE_STATUS, completion, context);
+		}
+	}
+}
+
+#endif // !RN4020_PIPELINE_H_
@@ -0,0 +1,22 @@
+#include "Advertisement.h"
+#include "../Util/Hex.h"
+
+namespace Bluetooth
+{
+	Advertisement::Advertisement()
+		: m_Length(0)
+	{
+		m_Hex[0] = '\0';
+	}
+
+	Advertisement::Advertisement(const uint8_t* data, uint8_t len)
+		: m_Length(0)
+	{
+		m_Hex[0] = '\0';
+		if (len > MAX_ADVERTISEMENT_LEN)
+			return;
+
+		*Util::EncodeHexBytes(data, len, m_Hex) = '\0';
+		m_Length = len;
+	}
+}
@@ -0,0 +1,252 @@
+#ifndef ADVERTISEMENT_H_
+#define ADVERTISEMENT_H_
+
+// user libraries
+#include "UUID.h"
+
+// std libraries
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+
+namespace Bluetooth
+{
+	///
+	/// Maximum amount of bytes of an advertisement set with Broadcast
+	///
+	static const uint8_t MAX_ADVERTISEMENT_LEN = 25;
+
+	enum AdvertisementFlags
+	{
+		///
+		/// Discoverable for a limited time
+		///
+		ADVERTISEMENT_FLAG_LIMITED_DISCOVERABLE = 1 << 0,
+
+		///
+		/// Discoverable until stopped
+		///
+		ADVERTISEMENT_FLAG_GENERAL_DISCOVERABLE = 1 << 1,
+
+		///
+		/// Only Bluetooth Low Energy (which is the case for the RN4020)
+		///
+		ADVERTISEMENT_FLAG_BREDR_NOT_SUPPORTED = 1 << 2
+	};
+
+	///
+	/// Types of the AD structures (see the Bluetooth assigned numbers)
+	///
+	enum AdvertisementType
+	{
+		ADVERTISEMENT_TYPE_FLAGS = 0x01,
+		ADVERTISEMENT_TYPE_SERVICES_16 = 0x03,
+		ADVERTISEMENT_TYPE_SERVICES_128 = 0x07,
+		ADVERTISEMENT_TYPE_SHORT_NAME = 0x08,
+		ADVERTISEMENT_TYPE_COMPLETE_NAME = 0x09,
+		ADVERTISEMENT_TYPE_MANUFACTURER_DATA = 0xFF
+	};
+
+	///
+	/// Advertisement encoded as the hex parameter of the N command, so it can be (re)sent with
+	/// Broadcast without formatting it again. Build it with AdvertisementData::Encode.
+	///
+	class Advertisement
+	{
+	public:
+		///
+		/// Constructs an empty advertisement, which can't be broadcasted
+		///
+		Advertisement();
+
+		///
+		/// Encodes the raw AD structures
+		///
+		/// @param data		AD structures
+		/// @param len		Amount of bytes, an advertisement of more than 25 bytes stays empty
+		///
+		Advertisement(const uint8_t* data, uint8_t len);
+
+		///
+		/// Gets the encoded advertisement, the parameter of the N command
+		///
+		/// @return				null terminated hex string
+		///
+		const char* GetHex() const
+		{
+			return m_Hex;
+		}
+
+		///
+		/// Gets the amount of bytes of the advertisement (half of the hex digits)
+		///
+		/// @return				bytes
+		///
+		uint8_t GetLength() const
+		{
+			return m_Length;
+		}
+
+		bool IsEmpty() const
+		{
+			return m_Length == 0;
+		}
+
+	private:
+		char m_Hex[2 * MAX_ADVERTISEMENT_LEN + 1];
+		uint8_t m_Length;
+	};
+
+	///
+	/// Builds the AD structures of an advertisement, the size is part of the type so an
+	/// advertisement of more than 25 bytes fails to compile (size of array is negative). Each
+	/// Add returns a new builder, so they are chained:\n
+	/// AdvertisementData<>().Flags(ADVERTISEMENT_FLAG_GENERAL_DISCOVERABLE).CompleteName("Beacon").Encode()
+	///
+	/// @tparam TSize		Amount of bytes added
+	///
+	template <size_t TSize = 0>
+	class AdvertisementData
+	{
+		// the RN4020 rejects longer advertisements
+		typedef int assert_advertisement_is_at_most_25_bytes[(TSize <= MAX_ADVERTISEMENT_LEN) ? 1 : -1];
+
+	public:
+		///
+		/// Constructs an empty advertisement
+		///
+		AdvertisementData()
+		{
+			// in the constructor, so it only applies to the builders constructed empty
+			static_assert(TSize == 0, "an advertisement starts empty");
+		}
+
+		///
+		/// Adds the flags (3 bytes)
+		///
+		/// @param flags		AdvertisementFlags combined
+		/// @return				builder with the flags added
+		///
+		AdvertisementData<TSize + 3> Flags(uint8_t flags) const
+		{
+			return Add<1>(ADVERTISEMENT_TYPE_FLAGS, &flags);
+		}
+
+		///
+		/// Adds the complete local name (2 bytes + the length of the name)
+		///
+		/// @param name			Name literal, without the null terminator
+		/// @return				builder with the name added
+		///
+		template <size_t N>
+		AdvertisementData<TSize + 2 + N - 1> CompleteName(const char (&name)[N]) const
+		{
+			return Add<N - 1>(ADVERTISEMENT_TYPE_COMPLETE_NAME, reinterpret_cast<const uint8_t*>(name));
+		}
+
+		///
+		/// Adds the shortened local name (2 bytes + the length of the name)
+		///
+		/// @param name			Name literal, without the null terminator
+		/// @return				builder with the name added
+		///
+		template <size_t N>
+		AdvertisementData<TSize + 2 + N - 1> ShortName(const char (&name)[N]) const
+		{
+			return Add<N - 1>(ADVERTISEMENT_TYPE_SHORT_NAME, reinterpret_cast<const uint8_t*>(name));
+		}
+
+		///
+		/// Adds manufacturer specific data (4 bytes + the length of the data)
+		///
+		/// @param company		Company identifier (see the Bluetooth assigned numbers)
+		/// @param data			Data after the company identifier
+		/// @return				builder with the data added
+		///
+		template <size_t N>
+		AdvertisementData<TSize + 4 + N> ManufacturerData(uint16_t company, const uint8_t (&data)[N]) const
+		{
+			// company identifier little endian first
+			uint8_t payload[2 + N];
+			payload[0] = static_cast<uint8_t>(company & 0xFF);
+			payload[1] = static_cast<uint8_t>(company >> 8);
+			memcpy(payload + 2, data, N);
+
+			return Add<2 + N>(ADVERTISEMENT_TYPE_MANUFACTURER_DATA, payload);
+		}
+
+		///
+		/// Adds a complete list of one 16 bit service UUID (4 bytes)
+		///
+		/// @param uuid			Short UUID of the service
+		/// @return				builder with the service added
+		///
+		AdvertisementData<TSize + 4> Service(uint16_t uuid) const
+		{
+			const uint8_t payload[2] = { static_cast<uint8_t>(uuid & 0xFF), static_cast<uint8_t>(uuid >> 8) };
+			return Add<2>(ADVERTISEMENT_TYPE_SERVICES_16, payload);
+		}
+
+		///
+		/// Adds a complete list of one 128 bit service UUID (18 bytes)
+		///
+		/// @param uuid			UUID of the service
+		/// @return				builder with the service added
+		///
+		AdvertisementData<TSize + 18> Service(const UUID& uuid) const
+		{
+			// little endian, the UUID is stored as written
+			const uint8_t* bytes = uuid.GetLongUUID();
+
+			uint8_t payload[16];
+			for (uint8_t i = 0; i < 16; ++i)
+				payload[i] = bytes[15 - i];
+
+			return Add<16>(ADVERTISEMENT_TYPE_SERVICES_128, payload);
+		}
+
+		///
+		/// Encodes the advertisement for Broadcast
+		///
+		/// @return				the encoded advertisement
+		///
+		Advertisement Encode() const
+		{
+			return Advertisement(m_Data, TSize);
+		}
+
+		const uint8_t* GetData() const
+		{
+			return m_Data;
+		}
+
+		uint8_t GetLength() const
+		{
+			return TSize;
+		}
+
+	private:
+		template <size_t> friend class AdvertisementData;
+
+		// large enough for every builder, so adding is a copy of a fixed size
+		uint8_t m_Data[MAX_ADVERTISEMENT_LEN];
+
+		explicit AdvertisementData(const uint8_t* data)
+		{
+			memcpy(m_Data, data, sizeof(m_Data));
+		}
+
+		template <size_t TLen>
+		AdvertisementData<TSize + 2 + TLen> Add(uint8_t type, const uint8_t* data) const
+		{
+			AdvertisementData<TSize + 2 + TLen> next(m_Data);
+			next.m_Data[TSize] = static_cast<uint8_t>(TLen + 1);
+			next.m_Data[TSize + 1] = type;
+			memcpy(next.m_Data + TSize + 2, data, TLen);
+
+			return next;
+		}
+	};
+}
+
+#endif // !ADVERTISEMENT_H_
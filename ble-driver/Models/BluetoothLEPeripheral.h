@@ -119,6 +119,15 @@ namespace Bluetooth
 		UUID m_PrimaryService;
 		int8_t m_RSSI;
 	};
+
+	/// 
+	/// Called for each advertisement received while scanning
+	///
+	/// @param context		Context passed when starting the scan
+	/// @param peripheral	The advertising Peripheral
+	/// @return	true to continue scanning, false to stop
+	/// 
+	typedef bool (*ScanCallback)(void* context, const BluetoothLEPeripheral& peripheral);
 }
 
 #endif // !BLUETOOTH_LE_PERIPHERAL_H_
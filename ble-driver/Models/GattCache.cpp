@@ -0,0 +1,245 @@
+#include "GattCache.h"
+
+// std libraries
+#include <cstring>
+
+// file format: header, then per peer the MAC Address and its services each followed by
+// its characteristics (all integers little endian)
+#define FILE_MAGIC "GATC"
+#define FILE_VERSION 1
+
+namespace
+{
+	bool writeBytes(FILE* file, const void* data, size_t len)
+	{
+		return fwrite(data, 1, len, file) == len;
+	}
+
+	bool readBytes(FILE* file, void* data, size_t len)
+	{
+		return fread(data, 1, len, file) == len;
+	}
+
+	bool writeTable(FILE* file, const Bluetooth::GattTable& table)
+	{
+		uint8_t serviceCount = table.GetServiceCount();
+		if (!writeBytes(file, &serviceCount, 1))
+			return false;
+
+		for (uint8_t i = 0; i < serviceCount; ++i)
+		{
+			const Bluetooth::GattTable::Service& service = table.GetService(i);
+			if (!writeBytes(file, service.Uuid.GetLongUUID(), 16) || !writeBytes(file, &service.Count, 1))
+				return false;
+
+			for (uint8_t j = service.First; j < service.First + service.Count; ++j)
+			{
+				const Bluetooth::GattTable::Characteristic& characteristic = table.GetCharacteristic(j);
+
+				uint8_t record[4] =
+				{
+					static_cast<uint8_t>(characteristic.Handle & 0xFF),
+					static_cast<uint8_t>(characteristic.Handle >> 8),
+					characteristic.Property,
+					static_cast<uint8_t>(characteristic.IsConfiguration ? 1 : 0)
+				};
+
+				if (!writeBytes(file, characteristic.Uuid.GetLongUUID(), 16) || !writeBytes(file, record, sizeof(record)))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool readTable(FILE* file, Bluetooth::GattTable* table)
+	{
+		table->Clear();
+
+		uint8_t serviceCount;
+		if (!readBytes(file, &serviceCount, 1))
+			return false;
+
+		for (uint8_t i = 0; i < serviceCount; ++i)
+		{
+			uint8_t uuid[16];
+			uint8_t characteristicCount;
+			if (!readBytes(file, uuid, sizeof(uuid)) || !readBytes(file, &characteristicCount, 1))
+				return false;
+
+			// the tables are written by Save, so they always fit
+			if (!table->AddService(Bluetooth::UUID(uuid)))
+				return false;
+
+			for (uint8_t j = 0; j < characteristicCount; ++j)
+			{
+				uint8_t record[4];
+				if (!readBytes(file, uuid, sizeof(uuid)) || !readBytes(file, record, sizeof(record)))
+					return false;
+
+				uint16_t handle = static_cast<uint16_t>(record[0] | record[1] << 8);
+				if (!table->AddCharacteristic(Bluetooth::UUID(uuid), handle, record[2], record[3] != 0))
+					return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+namespace Bluetooth
+{
+	GattCache::GattCache(Entry* storage, uint8_t capacity)
+		: m_Entries(storage),
+		  m_Capacity(capacity),
+		  m_Clock(0)
+	{
+	}
+
+	const GattTable* GattCache::Find(const MACAddress& address)
+	{
+		Entry* entry = FindEntry(address);
+		if (entry == NULL)
+			return NULL;
+
+		entry->LastUsed = ++m_Clock;
+		return &entry->Table;
+	}
+
+	const GattTable* GattCache::Store(const MACAddress& address, const GattTable& table, bool* changed)
+	{
+		Entry* entry = FindEntry(address);
+		bool isChanged = entry == NULL || !entry->Table.Equals(table);
+
+		if (entry == NULL)
+			entry = AcquireEntry(address);
+
+		if (changed)
+			*changed = isChanged;
+
+		if (entry == NULL)
+			return NULL;
+
+		if (isChanged)
+			entry->Table = table;
+
+		entry->LastUsed = ++m_Clock;
+		return &entry->Table;
+	}
+
+	bool GattCache::Invalidate(const MACAddress& address)
+	{
+		Entry* entry = FindEntry(address);
+		if (entry == NULL)
+			return false;
+
+		entry->Used = false;
+		return true;
+	}
+
+	void GattCache::Clear()
+	{
+		for (uint8_t i = 0; i < m_Capacity; ++i)
+			m_Entries[i].Used = false;
+	}
+
+	bool GattCache::Save(FILE* file) const
+	{
+		uint8_t header[6] = { FILE_MAGIC[0], FILE_MAGIC[1], FILE_MAGIC[2], FILE_MAGIC[3], FILE_VERSION, GetCount() };
+		if (!writeBytes(file, header, sizeof(header)))
+			return false;
+
+		// least recently used first, so loading restores the order
+		uint32_t previous = 0;
+		for (uint8_t written = 0; written < header[5]; ++written)
+		{
+			const Entry* next = NULL;
+			for (uint8_t i = 0; i < m_Capacity; ++i)
+			{
+				const Entry& entry = m_Entries[i];
+				if (entry.Used && (written == 0 || entry.LastUsed > previous) && (next == NULL || entry.LastUsed < next->LastUsed))
+					next = &entry;
+			}
+
+			if (!writeBytes(file, next->Address.GetArray(), 6) || !writeTable(file, next->Table))
+				return false;
+
+			previous = next->LastUsed;
+		}
+
+		return fflush(file) == 0;
+	}
+
+	bool GattCache::Load(FILE* file)
+	{
+		Clear();
+
+		uint8_t header[6];
+		if (!readBytes(file, header, sizeof(header)) || memcmp(header, FILE_MAGIC, 4) != 0 || header[4] != FILE_VERSION)
+			return false;
+
+		GattTable table;
+		for (uint8_t i = 0; i < header[5]; ++i)
+		{
+			uint8_t address[6];
+			if (!readBytes(file, address, sizeof(address)) || !readTable(file, &table))
+			{
+				Clear();
+				return false;
+			}
+
+			// with a smaller capacity the least recently used tables are replaced
+			Store(MACAddress(address), table);
+		}
+
+		return true;
+	}
+
+	uint8_t GattCache::GetCount() const
+	{
+		uint8_t count = 0;
+		for (uint8_t i = 0; i < m_Capacity; ++i)
+		{
+			if (m_Entries[i].Used)
+				++count;
+		}
+
+		return count;
+	}
+
+	GattCache::Entry* GattCache::FindEntry(const MACAddress& address) const
+	{
+		for (uint8_t i = 0; i < m_Capacity; ++i)
+		{
+			if (m_Entries[i].Used && m_Entries[i].Address == address)
+				return m_Entries + i;
+		}
+
+		return NULL;
+	}
+
+	GattCache::Entry* GattCache::AcquireEntry(const MACAddress& address)
+	{
+		// a free slot or else the least recently used one
+		Entry* entry = NULL;
+		for (uint8_t i = 0; i < m_Capacity; ++i)
+		{
+			Entry& candidate = m_Entries[i];
+			if (!candidate.Used)
+			{
+				entry = &candidate;
+				break;
+			}
+
+			if (entry == NULL || candidate.LastUsed < entry->LastUsed)
+				entry = &candidate;
+		}
+
+		if (entry == NULL)
+			return NULL;
+
+		entry->Address = address;
+		entry->Used = true;
+		return entry;
+	}
+}
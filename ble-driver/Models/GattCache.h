@@ -0,0 +1,128 @@
+#ifndef GATT_CACHE_H_
+#define GATT_CACHE_H_
+
+// user libraries
+#include "GattTable.h"
+#include "MACAddress.h"
+
+// std libraries
+#include <cstdio>
+
+namespace Bluetooth
+{
+	///
+	/// Cache of the discovered GATT tables of the peers, keyed by MAC Address, so the
+	/// discovery (LC) can be skipped when reconnecting (see RN4020Device::DiscoverClient).\n
+	/// The storage is given by the caller (see StaticGattCache), when full the least recently
+	/// used table is replaced. The cache can be saved to and loaded from a file to survive
+	/// restarts.
+	///
+	class GattCache
+	{
+	public:
+		///
+		/// Slot of the cache
+		///
+		struct Entry
+		{
+			Entry() : LastUsed(0), Used(false)
+			{
+			}
+
+			MACAddress Address;
+			GattTable Table;
+			uint32_t LastUsed;
+			bool Used;
+		};
+
+		///
+		/// Constructs an empty cache on the storage
+		///
+		/// @param storage		Unused slots to use (not owned by the cache)
+		/// @param capacity		Amount of slots
+		///
+		GattCache(Entry* storage, uint8_t capacity);
+
+		///
+		/// Finds the table of a peer and marks it as most recently used
+		///
+		/// @param address		MAC Address of the peer
+		/// @return	the table, NULL if not cached
+		///
+		const GattTable* Find(const MACAddress& address);
+
+		///
+		/// Stores the (re)discovered table of a peer
+		///
+		/// @param address		MAC Address of the peer
+		/// @param table		The discovered table
+		/// @param changed		Set if it differs from the cached table or wasn't cached (may be NULL)
+		/// @return	the cached table
+		///
+		const GattTable* Store(const MACAddress& address, const GattTable& table, bool* changed = NULL);
+
+		///
+		/// Removes the table of a peer, e.g. when a cached handle was rejected
+		///
+		/// @param address		MAC Address of the peer
+		/// @return	true if it was cached
+		///
+		bool Invalidate(const MACAddress& address);
+
+		///
+		/// Removes all tables
+		///
+		void Clear();
+
+		///
+		/// Writes all tables to a (binary) file
+		///
+		/// @param file			File opened for writing
+		/// @return	true if operation completed succesfully
+		///
+		bool Save(FILE* file) const;
+
+		///
+		/// Replaces the cache with the tables of a file written by Save. Tables which don't fit
+		/// are skipped.
+		///
+		/// @param file			File opened for reading
+		/// @return	false if the file is invalid (the cache is then empty)
+		///
+		bool Load(FILE* file);
+
+		uint8_t GetCount() const;
+
+		uint8_t GetCapacity() const
+		{
+			return m_Capacity;
+		}
+
+	private:
+		Entry* m_Entries;
+		uint8_t m_Capacity;
+		uint32_t m_Clock;
+
+		Entry* FindEntry(const MACAddress& address) const;
+		Entry* AcquireEntry(const MACAddress& address);
+	};
+
+	///
+	/// GattCache with its own storage
+	///
+	/// @tparam TCapacity		Amount of peers to cache
+	///
+	template <uint8_t TCapacity>
+	class StaticGattCache : public GattCache
+	{
+	public:
+		StaticGattCache() : GattCache(m_Storage, TCapacity)
+		{
+		}
+
+	private:
+		Entry m_Storage[TCapacity];
+	};
+}
+
+#endif // !GATT_CACHE_H_
@@ -0,0 +1,161 @@
+#include "GattTable.h"
+
+namespace Bluetooth
+{
+	GattTable::GattTable()
+		: m_ServiceCount(0),
+		  m_CharacteristicCount(0)
+	{
+	}
+
+	void GattTable::Clear()
+	{
+		m_ServiceCount = 0;
+		m_CharacteristicCount = 0;
+	}
+
+	bool GattTable::AddService(const UUID& uuid)
+	{
+		if (m_ServiceCount >= MAX_SERVICES)
+			return false;
+
+		Service& service = m_Services[m_ServiceCount++];
+		service.Uuid = uuid;
+		service.First = m_CharacteristicCount;
+		service.Count = 0;
+
+		return true;
+	}
+
+	bool GattTable::AddCharacteristic(const UUID& uuid, uint16_t handle, uint8_t property, bool isConfiguration)
+	{
+		if (m_ServiceCount == 0 || m_CharacteristicCount >= MAX_CHARACTERISTICS)
+			return false;
+
+		uint8_t index = m_CharacteristicCount++;
+
+		Characteristic& characteristic = m_Characteristics[index];
+		characteristic.Uuid = uuid;
+		characteristic.Handle = handle;
+		characteristic.Service = m_ServiceCount - 1;
+		characteristic.Property = property;
+		characteristic.IsConfiguration = isConfiguration;
+
+		++m_Services[m_ServiceCount - 1].Count;
+
+		// the listing is in handle order, so this normally appends without moving anything
+		uint8_t i = index;
+		while (i > 0 && m_Characteristics[m_ByHandle[i - 1]].Handle > handle)
+		{
+			m_ByHandle[i] = m_ByHandle[i - 1];
+			--i;
+		}
+
+		m_ByHandle[i] = index;
+
+		// equal UUIDs stay in handle order, so the value handle comes before the configuration
+		i = index;
+		while (i > 0 && uuid < m_Characteristics[m_ByUUID[i - 1]].Uuid)
+		{
+			m_ByUUID[i] = m_ByUUID[i - 1];
+			--i;
+		}
+
+		m_ByUUID[i] = index;
+		return true;
+	}
+
+	const GattTable::Characteristic* GattTable::FindByHandle(uint16_t handle) const
+	{
+		uint8_t low = 0;
+		uint8_t high = m_CharacteristicCount;
+		while (low < high)
+		{
+			uint8_t middle = low + (high - low) / 2;
+			const Characteristic& characteristic = m_Characteristics[m_ByHandle[middle]];
+
+			if (characteristic.Handle == handle)
+				return &characteristic;
+
+			if (characteristic.Handle < handle)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		return NULL;
+	}
+
+	const GattTable::Characteristic* GattTable::FindByUUID(const UUID& uuid, const UUID* service) const
+	{
+		// first characteristic with the UUID
+		uint8_t low = 0;
+		uint8_t high = m_CharacteristicCount;
+		while (low < high)
+		{
+			uint8_t middle = low + (high - low) / 2;
+			if (m_Characteristics[m_ByUUID[middle]].Uuid < uuid)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		// the same characteristic may be part of several services
+		for (; low < m_CharacteristicCount; ++low)
+		{
+			const Characteristic& characteristic = m_Characteristics[m_ByUUID[low]];
+			if (characteristic.Uuid != uuid)
+				break;
+
+			if (service == NULL || m_Services[characteristic.Service].Uuid == *service)
+				return &characteristic;
+		}
+
+		return NULL;
+	}
+
+	const GattTable::Service* GattTable::FindService(const UUID& uuid) const
+	{
+		for (uint8_t i = 0; i < m_ServiceCount; ++i)
+		{
+			if (m_Services[i].Uuid == uuid)
+				return m_Services + i;
+		}
+
+		return NULL;
+	}
+
+	bool GattTable::Equals(const GattTable& other) const
+	{
+		if (m_ServiceCount != other.m_ServiceCount || m_CharacteristicCount != other.m_CharacteristicCount)
+			return false;
+
+		for (uint8_t i = 0; i < m_ServiceCount; ++i)
+		{
+			const Service& lhs = m_Services[i];
+			const Service& rhs = other.m_Services[i];
+			if (lhs.Uuid != rhs.Uuid || lhs.First != rhs.First || lhs.Count != rhs.Count)
+				return false;
+		}
+
+		for (uint8_t i = 0; i < m_CharacteristicCount; ++i)
+		{
+			const Characteristic& lhs = m_Characteristics[i];
+			const Characteristic& rhs = other.m_Characteristics[i];
+			if (lhs.Uuid != rhs.Uuid || lhs.Handle != rhs.Handle || lhs.Property != rhs.Property || lhs.IsConfiguration != rhs.IsConfiguration)
+				return false;
+		}
+
+		return true;
+	}
+
+	LongServerCharacteristic GattTable::ToServerCharacteristic(const Characteristic& characteristic) const
+	{
+		return LongServerCharacteristic(m_Services[characteristic.Service].Uuid, characteristic.Uuid, characteristic.Handle, characteristic.IsConfiguration);
+	}
+
+	LongClientCharacteristic GattTable::ToClientCharacteristic(const Characteristic& characteristic) const
+	{
+		return LongClientCharacteristic(m_Services[characteristic.Service].Uuid, characteristic.Uuid, characteristic.Handle, static_cast<CharacteristicProperty>(characteristic.Property));
+	}
+}
@@ -0,0 +1,157 @@
+#ifndef GATT_TABLE_H_
+#define GATT_TABLE_H_
+
+// user libraries
+#include "UUID.h"
+#include "CharacteristicProperty.h"
+#include "ServerCharacteristic.h"
+#include "ClientCharacteristic.h"
+
+namespace Bluetooth
+{
+	///
+	/// Flat table of the services and characteristics of a GATT server, filled from a single
+	/// listing (see RN4020Driver::DiscoverServer and DiscoverClient). The characteristics are
+	/// stored in the order of the listing, grouped per service, and are indexed by handle and
+	/// by UUID so FindByHandle and FindByUUID are binary searches.
+	///
+	class GattTable
+	{
+	public:
+		static const uint8_t MAX_SERVICES = 16;
+		static const uint8_t MAX_CHARACTERISTICS = 64;
+
+		///
+		/// Service with the range of its characteristics in the table
+		///
+		struct Service
+		{
+			UUID Uuid;
+			uint8_t First;
+			uint8_t Count;
+		};
+
+		///
+		/// Characteristic (or configuration) handle of a service
+		///
+		struct Characteristic
+		{
+			UUID Uuid;
+			uint16_t Handle;
+			uint8_t Service;
+			uint8_t Property;
+			bool IsConfiguration;
+		};
+
+		///
+		/// Constructs an empty table
+		///
+		GattTable();
+
+		///
+		/// Removes all services and characteristics
+		///
+		void Clear();
+
+		///
+		/// Adds a service, the following characteristics belong to it
+		///
+		/// @param uuid			UUID of the service
+		/// @return	false if the table is full
+		///
+		bool AddService(const UUID& uuid);
+
+		///
+		/// Adds a characteristic to the last added service
+		///
+		/// @param uuid				UUID of the characteristic
+		/// @param handle			Handle of the characteristic
+		/// @param property			Property bitmap (CharacteristicProperty, 0 if unknown)
+		/// @param isConfiguration	Specifies if the handle is the configuration
+		/// @return	false if there is no service or the table is full
+		///
+		bool AddCharacteristic(const UUID& uuid, uint16_t handle, uint8_t property, bool isConfiguration);
+
+		///
+		/// Finds a characteristic by its handle
+		///
+		/// @param handle		Handle of the characteristic
+		/// @return	the characteristic, NULL if not in the table
+		///
+		const Characteristic* FindByHandle(uint16_t handle) const;
+
+		///
+		/// Finds the first (value) handle of a characteristic by its UUID
+		///
+		/// @param uuid			UUID of the characteristic
+		/// @param service		Only searches this service (may be NULL)
+		/// @return	the characteristic, NULL if not in the table
+		///
+		const Characteristic* FindByUUID(const UUID& uuid, const UUID* service = NULL) const;
+
+		///
+		/// Finds a service by its UUID
+		///
+		/// @param uuid			UUID of the service
+		/// @return	the service, NULL if not in the table
+		///
+		const Service* FindService(const UUID& uuid) const;
+
+		///
+		/// Compares all services and characteristics (e.g. to detect a changed GATT server)
+		///
+		/// @param other		Table to compare with
+		/// @return	true if both tables hold the same services and characteristics
+		///
+		bool Equals(const GattTable& other) const;
+
+		///
+		/// Converts a characteristic to the model of the Server
+		///
+		/// @param characteristic	Characteristic of the table
+		/// @return	the Server Characteristic
+		///
+		LongServerCharacteristic ToServerCharacteristic(const Characteristic& characteristic) const;
+
+		///
+		/// Converts a characteristic to the model of the Client
+		///
+		/// @param characteristic	Characteristic of the table
+		/// @return	the Client Characteristic
+		///
+		LongClientCharacteristic ToClientCharacteristic(const Characteristic& characteristic) const;
+
+		const Service& GetService(uint8_t index) const
+		{
+			return m_Services[index];
+		}
+
+		uint8_t GetServiceCount() const
+		{
+			return m_ServiceCount;
+		}
+
+		const Characteristic& GetCharacteristic(uint8_t index) const
+		{
+			return m_Characteristics[index];
+		}
+
+		uint8_t GetCharacteristicCount() const
+		{
+			return m_CharacteristicCount;
+		}
+
+	private:
+		Service m_Services[MAX_SERVICES];
+		uint8_t m_ServiceCount;
+
+		Characteristic m_Characteristics[MAX_CHARACTERISTICS];
+		uint8_t m_CharacteristicCount;
+
+		// indices of the characteristics sorted by handle, and by UUID (then by handle)
+		uint8_t m_ByHandle[MAX_CHARACTERISTICS];
+		uint8_t m_ByUUID[MAX_CHARACTERISTICS];
+	};
+}
+
+#endif // !GATT_TABLE_H_
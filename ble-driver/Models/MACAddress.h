@@ -1,22 +1,29 @@
 ﻿#ifndef MACADDRESS_H_
 #define MACADDRESS_H_
 
+#include "../Util/Hex.h"
+
+#include <cstddef>
 #include <inttypes.h>
 
 class MACAddress
 {
 public:
 	/// 
-	/// Constructs empty MAC Address
+	/// Constructs empty MAC Address (FF:FF:FF:FF:FF:FF)
 	/// 
-	explicit MACAddress();
+	constexpr explicit MACAddress() : m_Value(VALUE_MASK)
+	{
+	}
 
 	/// 
 	/// Constructs MAC Address from a 64 bit integer
 	///
-	/// @param a_Value		zero extended value of 48 bit MAC Address
+	/// @param a_Value		zero extended value of 48 bit MAC Address (the upper 16 bits are ignored)
 	/// 
-	explicit MACAddress(uint64_t a_Value);
+	constexpr explicit MACAddress(uint64_t a_Value) : m_Value(a_Value & VALUE_MASK)
+	{
+	}
 	
 	/// 
 	/// Cosntructs MAC Address from 6 byte array
@@ -32,8 +39,20 @@ public:
 	/// 
 	explicit MACAddress(const char* a_String);
 
-	MACAddress(const MACAddress& a_Other);
-	MACAddress& operator=(const MACAddress& a_Other);
+	/// 
+	/// Constructs MAC Address from hex string at compile time (see the _mac literal), use
+	/// MACAddress(const char*) for strings only known at runtime.
+	///
+	/// @param a_String		12 char long hex string (no seperators)
+	/// @param a_Length		length of the string, anything else than 12 fails to compile when
+	///						constant evaluated (else the address is zero)
+	/// 
+	constexpr MACAddress(const char* a_String, size_t a_Length) : m_Value(LiteralValue(a_String, a_Length, 0))
+	{
+	}
+
+	MACAddress(const MACAddress& a_Other) = default;
+	MACAddress& operator=(const MACAddress& a_Other) = default;
 
 	/// 
 	/// Gets the MAC Address as zero extended 64 bit integer
@@ -59,13 +78,57 @@ public:
 	/// 
 	void ToCharArray(char* buf, uint8_t len, char seperator = ':') const;
 
+	bool operator==(const MACAddress& a_Other) const
+	{
+		return m_Value == a_Other.m_Value;
+	}
+
+	bool operator!=(const MACAddress& a_Other) const
+	{
+		return m_Value != a_Other.m_Value;
+	}
+
+	/// 
+	/// Mask of the 48 bits of the MAC Address in the value, the upper 16 bits are always zero
+	/// so the value can be compared and hashed as a key.
+	/// 
+	static const uint64_t VALUE_MASK = 0x0000FFFFFFFFFFFFULL;
+
 private:
 	union
 	{
 		uint8_t m_Array[6];
 		uint64_t m_Value;
 	};
+
+	// the value of the bytes in m_Array, so the first byte is the least significant one (like
+	// m_Value and VALUE_MASK this assumes a little endian target)
+	static constexpr uint64_t LiteralValue(const char* hex, size_t len, uint8_t index)
+	{
+		return len != 12 || Util::ConstHexPair(hex + index * 2) < 0 ? InvalidLiteral()
+			: static_cast<uint64_t>(Util::ConstHexPair(hex + index * 2)) << (index * 8) | (index < 5 ? LiteralValue(hex, len, index + 1) : 0);
+	}
+
+	// not constexpr, so an invalid literal fails to compile when constant evaluated
+	static uint64_t InvalidLiteral();
 };
 
+namespace Bluetooth
+{
+	inline namespace Literals
+	{
+		/// 
+		/// MAC Address built at compile time, e.g. "001EC01A2B3C"_mac. Since C++20 the literal is
+		/// consteval, so an invalid one always fails to compile. Before that it only does in a
+		/// constant expression (e.g. a constexpr variable), elsewhere it may be evaluated at
+		/// runtime and results in a zero address.
+		/// 
+		HEX_LITERAL MACAddress operator"" _mac(const char* str, size_t len)
+		{
+			return MACAddress(str, len);
+		}
+	}
+}
+
 
 #endif // !MACADDRESS_H_
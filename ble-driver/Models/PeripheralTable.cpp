@@ -0,0 +1,175 @@
+#include "PeripheralTable.h"
+
+namespace
+{
+	// 2^64 / golden ratio, spreads the (often sequential) MAC Addresses over the table
+	const uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+}
+
+namespace Bluetooth
+{
+	PeripheralTable::PeripheralTable(Entry* storage, uint16_t capacity)
+		: m_Entries(storage),
+		  m_Capacity(capacity),
+		  m_Mask(capacity - 1),
+		  m_MaxCount(capacity - (capacity / 4 > 0 ? capacity / 4 : 1)),
+		  m_Shift(64),
+		  m_Count(0)
+	{
+		// the upper bits of the product are the best mixed
+		for (uint16_t i = capacity; i > 1; i >>= 1)
+			--m_Shift;
+	}
+
+	const PeripheralTable::Entry* PeripheralTable::Update(const BluetoothLEPeripheral& peripheral)
+	{
+		return Update(peripheral, Clock::now());
+	}
+
+	const PeripheralTable::Entry* PeripheralTable::Update(const BluetoothLEPeripheral& peripheral, Clock::time_point now)
+	{
+		// at least one slot must stay free to end the probing
+		if (m_MaxCount == 0)
+			return NULL;
+
+		uint16_t index;
+		if (!FindIndex(peripheral.GetMACAddress(), &index))
+		{
+			if (m_Count >= m_MaxCount)
+			{
+				EvictOldest();
+
+				// the eviction may have shifted the free slot
+				FindIndex(peripheral.GetMACAddress(), &index);
+			}
+
+			m_Entries[index].Used = true;
+			m_Entries[index].Advertisements = 0;
+			++m_Count;
+		}
+
+		Entry& entry = m_Entries[index];
+		entry.Peripheral = peripheral;
+		entry.LastSeen = now;
+		++entry.Advertisements;
+
+		return &entry;
+	}
+
+	const PeripheralTable::Entry* PeripheralTable::Find(const MACAddress& address) const
+	{
+		uint16_t index;
+		if (m_Count == 0 || !FindIndex(address, &index))
+			return NULL;
+
+		return m_Entries + index;
+	}
+
+	bool PeripheralTable::Remove(const MACAddress& address)
+	{
+		uint16_t index;
+		if (m_Count == 0 || !FindIndex(address, &index))
+			return false;
+
+		RemoveAt(index);
+		return true;
+	}
+
+	uint16_t PeripheralTable::RemoveOlderThan(Clock::time_point time)
+	{
+		uint16_t removed = 0;
+		uint16_t index = 0;
+		while (index < m_Capacity)
+		{
+			// the shift may move another entry into this slot, so check it again
+			if (m_Entries[index].Used && m_Entries[index].LastSeen < time)
+			{
+				RemoveAt(index);
+				++removed;
+				continue;
+			}
+
+			++index;
+		}
+
+		return removed;
+	}
+
+	void PeripheralTable::Clear()
+	{
+		for (uint16_t i = 0; i < m_Capacity; ++i)
+			m_Entries[i].Used = false;
+
+		m_Count = 0;
+	}
+
+	bool PeripheralTable::Collect(void* context, const BluetoothLEPeripheral& peripheral)
+	{
+		static_cast<PeripheralTable*>(context)->Update(peripheral);
+		return true;
+	}
+
+	uint16_t PeripheralTable::GetHome(const MACAddress& address) const
+	{
+		if (m_Shift == 64)
+			return 0;
+
+		return static_cast<uint16_t>((address.GetValue() * HASH_MULTIPLIER) >> m_Shift);
+	}
+
+	bool PeripheralTable::FindIndex(const MACAddress& address, uint16_t* index) const
+	{
+		// the table is never full, so there is always a free slot to stop at
+		uint16_t i = GetHome(address);
+		while (m_Entries[i].Used)
+		{
+			if (m_Entries[i].Peripheral.GetMACAddress() == address)
+			{
+				*index = i;
+				return true;
+			}
+
+			i = (i + 1) & m_Mask;
+		}
+
+		*index = i;
+		return false;
+	}
+
+	void PeripheralTable::RemoveAt(uint16_t index)
+	{
+		// backward shift deletion: move the following entries of the cluster back if the
+		// freed slot is between their home and their current slot, so no tombstones are needed
+		uint16_t hole = index;
+		uint16_t i = (index + 1) & m_Mask;
+		while (m_Entries[i].Used)
+		{
+			uint16_t home = GetHome(m_Entries[i].Peripheral.GetMACAddress());
+
+			// distance from home to the current slot and to the hole (wrapping)
+			if (((i - home) & m_Mask) >= ((i - hole) & m_Mask))
+			{
+				m_Entries[hole] = m_Entries[i];
+				hole = i;
+			}
+
+			i = (i + 1) & m_Mask;
+		}
+
+		m_Entries[hole].Used = false;
+		--m_Count;
+	}
+
+	void PeripheralTable::EvictOldest()
+	{
+		uint16_t oldest = m_Capacity;
+		for (uint16_t i = 0; i < m_Capacity; ++i)
+		{
+			if (m_Entries[i].Used && (oldest == m_Capacity || m_Entries[i].LastSeen < m_Entries[oldest].LastSeen))
+				oldest = i;
+		}
+
+		if (oldest != m_Capacity)
+			RemoveAt(oldest);
+	}
+}
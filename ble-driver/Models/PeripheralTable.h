@@ -0,0 +1,157 @@
+#ifndef PERIPHERAL_TABLE_H_
+#define PERIPHERAL_TABLE_H_
+
+// user libraries
+#include "BluetoothLEPeripheral.h"
+
+// std libraries
+#include <chrono>
+
+namespace Bluetooth
+{
+	///
+	/// Table of the Peripherals seen while scanning, keyed by MAC Address. Every advertisement
+	/// of a known Peripheral updates its entry in place (RSSI, last seen time and the amount of
+	/// advertisements), so a chatty advertiser only takes a single entry.\n
+	/// It is an open addressing hash table with linear probing on storage given by the caller
+	/// (see StaticPeripheralTable), so the memory is bounded. It is filled up to 3/4 of the
+	/// capacity to keep the probes short, when full the least recently seen Peripheral is
+	/// replaced by a new one.
+	///
+	class PeripheralTable
+	{
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		///
+		/// Slot of the table
+		///
+		struct Entry
+		{
+			Entry() : Advertisements(0), Used(false)
+			{
+			}
+
+			BluetoothLEPeripheral Peripheral;
+			Clock::time_point LastSeen;
+			uint32_t Advertisements;
+			bool Used;
+		};
+
+		///
+		/// Constructs an empty table on the storage
+		///
+		/// @param storage		Unused slots to use (not owned by the table)
+		/// @param capacity		Amount of slots (must be a power of two, at least 2)
+		///
+		PeripheralTable(Entry* storage, uint16_t capacity);
+
+		///
+		/// Adds the Peripheral of an advertisement or updates it if it is already known
+		///
+		/// @param peripheral	The advertising Peripheral
+		/// @return	the entry of the Peripheral
+		///
+		const Entry* Update(const BluetoothLEPeripheral& peripheral);
+
+		///
+		/// Adds the Peripheral of an advertisement or updates it if it is already known
+		///
+		/// @param peripheral	The advertising Peripheral
+		/// @param now			Time at which it was seen
+		/// @return	the entry of the Peripheral
+		///
+		const Entry* Update(const BluetoothLEPeripheral& peripheral, Clock::time_point now);
+
+		///
+		/// Finds the entry of a Peripheral
+		///
+		/// @param address		MAC Address of the Peripheral
+		/// @return	the entry, NULL if not in the table
+		///
+		const Entry* Find(const MACAddress& address) const;
+
+		///
+		/// Removes a Peripheral from the table
+		///
+		/// @param address		MAC Address of the Peripheral
+		/// @return	true if it was in the table
+		///
+		bool Remove(const MACAddress& address);
+
+		///
+		/// Removes the Peripherals which haven't been seen since the time
+		///
+		/// @param time			Oldest last seen time to keep
+		/// @return	amount of removed Peripherals
+		///
+		uint16_t RemoveOlderThan(Clock::time_point time);
+
+		///
+		/// Removes all Peripherals
+		///
+		void Clear();
+
+		///
+		/// Gets a slot of the table to iterate over all Peripherals (check Entry::Used)
+		///
+		/// @param index		Index of the slot (less than GetCapacity)
+		/// @return	the slot
+		///
+		const Entry& GetEntry(uint16_t index) const
+		{
+			return m_Entries[index];
+		}
+
+		uint16_t GetCount() const
+		{
+			return m_Count;
+		}
+
+		uint16_t GetCapacity() const
+		{
+			return m_Capacity;
+		}
+
+		///
+		/// ScanCallback which updates the table passed as context, to scan directly into a table:
+		/// device.ScanPeripherals(PeripheralTable::Collect, &table, 5000)
+		///
+		static bool Collect(void* context, const BluetoothLEPeripheral& peripheral);
+
+	private:
+		Entry* m_Entries;
+		uint16_t m_Capacity;
+		uint16_t m_Mask;
+		uint16_t m_MaxCount;
+		uint8_t m_Shift;
+		uint16_t m_Count;
+
+		uint16_t GetHome(const MACAddress& address) const;
+		bool FindIndex(const MACAddress& address, uint16_t* index) const;
+		void RemoveAt(uint16_t index);
+		void EvictOldest();
+	};
+
+	///
+	/// PeripheralTable with its own storage
+	///
+	/// @tparam TCapacity		Amount of slots (must be power of two)
+	///
+	template <uint16_t TCapacity>
+	class StaticPeripheralTable : public PeripheralTable
+	{
+		// linear probing wraps with a mask
+		typedef int assert_TCapacity_is_power_of_two[((TCapacity & (TCapacity - 1)) == 0) ? 1 : -1];
+
+	public:
+		StaticPeripheralTable() : PeripheralTable(m_Storage, TCapacity)
+		{
+		}
+
+	private:
+		Entry m_Storage[TCapacity];
+	};
+}
+
+#endif // !PERIPHERAL_TABLE_H_
@@ -0,0 +1,153 @@
+#include "ScanFilter.h"
+#include "../Util/Hex.h"
+
+// std libraries
+#include <cstring>
+
+namespace
+{
+	// Bluetooth_Base_UUID, bytes 2 and 3 hold the 16 bit UUID
+	const uint8_t BASE_UUID[16] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB };
+
+	bool isShortUUID(const uint8_t* uuid)
+	{
+		return memcmp(uuid, BASE_UUID, 2) == 0 && memcmp(uuid + 4, BASE_UUID + 4, 12) == 0;
+	}
+
+	// compares the complete field up to the ',' with the expected value
+	bool fieldEquals(const char* field, uint8_t fieldLength, const char* expected)
+	{
+		return expected[0] != '\0' && strlen(expected) == fieldLength && memcmp(field, expected, fieldLength) == 0;
+	}
+}
+
+namespace Bluetooth
+{
+	ScanFilter::ScanFilter()
+	{
+		Clear();
+	}
+
+	ScanFilter& ScanFilter::SetAddressPrefix(const MACAddress& address, uint8_t length)
+	{
+		if (length > 6)
+			length = 6;
+
+		address.ToCharArray(m_Address, sizeof(m_Address), '\0');
+		m_AddressLength = length * 2;
+
+		if (length > 0)
+			m_Criteria |= CRITERIA_ADDRESS;
+		else
+			m_Criteria &= ~CRITERIA_ADDRESS;
+
+		return *this;
+	}
+
+	ScanFilter& ScanFilter::SetNamePrefix(const char* prefix)
+	{
+		memset(m_Name, 0, sizeof(m_Name));
+		m_NameLength = 0;
+		m_Criteria &= ~CRITERIA_NAME;
+
+		if (prefix && *prefix)
+		{
+			strncpy(m_Name, prefix, sizeof(m_Name) - 1);
+			m_NameLength = static_cast<uint8_t>(strlen(m_Name));
+			m_Criteria |= CRITERIA_NAME;
+		}
+
+		return *this;
+	}
+
+	ScanFilter& ScanFilter::SetPrimaryService(const UUID& service)
+	{
+		const uint8_t* uuid = service.GetLongUUID();
+		*Util::EncodeHexBytes(uuid, 16, m_LongService) = '\0';
+
+		m_ShortService[0] = '\0';
+		if (isShortUUID(uuid))
+			*Util::EncodeHexBytes(uuid + 2, 2, m_ShortService) = '\0';
+
+		m_Criteria |= CRITERIA_SERVICE;
+		return *this;
+	}
+
+	ScanFilter& ScanFilter::SetMinimumRssi(int8_t rssi)
+	{
+		m_MinimumRssi = rssi;
+		m_Criteria |= CRITERIA_RSSI;
+
+		return *this;
+	}
+
+	void ScanFilter::Clear()
+	{
+		m_Criteria = 0;
+		memset(m_Address, 0, sizeof(m_Address));
+		m_AddressLength = 0;
+		memset(m_Name, 0, sizeof(m_Name));
+		m_NameLength = 0;
+		memset(m_ShortService, 0, sizeof(m_ShortService));
+		memset(m_LongService, 0, sizeof(m_LongService));
+		m_MinimumRssi = INT8_MIN;
+	}
+
+	bool ScanFilter::Matches(const char* line) const
+	{
+		// most scan traffic is rejected on the address (strncmp also stops at a short line)
+		if ((m_Criteria & CRITERIA_ADDRESS) && strncmp(line, m_Address, m_AddressLength) != 0)
+			return false;
+
+		if ((m_Criteria & ~CRITERIA_ADDRESS) == 0)
+			return true;
+
+		// MAC,type, without reading past the end of a short line
+		for (uint8_t i = 0; i < 15; ++i)
+		{
+			if (line[i] == '\0')
+				return false;
+		}
+
+		if (line[12] != ',' || line[14] != ',')
+			return false;
+
+		const char* name = line + 15;
+		if ((m_Criteria & CRITERIA_NAME) && strncmp(name, m_Name, m_NameLength) != 0)
+			return false;
+
+		const char* service = strchr(name, ',');
+		if (service == NULL)
+			return false;
+
+		++service;
+		const char* rssi = strchr(service, ',');
+		if (rssi == NULL)
+			return false;
+
+		if (m_Criteria & CRITERIA_SERVICE)
+		{
+			uint8_t length = static_cast<uint8_t>(rssi - service);
+			if (!fieldEquals(service, length, m_ShortService) && !fieldEquals(service, length, m_LongService))
+				return false;
+		}
+
+		if (m_Criteria & CRITERIA_RSSI)
+		{
+			++rssi;
+			bool negative = *rssi == '-';
+			if (negative)
+				++rssi;
+
+			uint32_t value;
+			if (Util::ParseHex(rssi, &value, 2) == 0)
+				return false;
+
+			int32_t signedValue = negative ? -static_cast<int32_t>(value) : static_cast<int32_t>(value);
+			if (signedValue < m_MinimumRssi)
+				return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,96 @@
+#ifndef SCAN_FILTER_H_
+#define SCAN_FILTER_H_
+
+// user libraries
+#include "MACAddress.h"
+#include "UUID.h"
+
+namespace Bluetooth
+{
+	///
+	/// Declarative filter of scan results. The criteria are compiled into the hex/text form in
+	/// which the RN4020 reports them, so Matches can reject a raw scan line
+	/// (MAC,type,name,uuid,rssi) with a few compares, before it is parsed into a
+	/// BluetoothLEPeripheral. An empty filter matches everything.
+	///
+	class ScanFilter
+	{
+	public:
+		///
+		/// Constructs a filter which matches every scan result
+		///
+		ScanFilter();
+
+		///
+		/// Only matches MAC Addresses starting with the first bytes of address (e.g. 3 bytes for
+		/// the OUI of a manufacturer)
+		///
+		/// @param address		MAC Address to match
+		/// @param length		Amount of bytes to match (1 up to 6, 0 removes the criterion)
+		/// @return	the filter, to chain the criteria
+		///
+		ScanFilter& SetAddressPrefix(const MACAddress& address, uint8_t length = 6);
+
+		///
+		/// Only matches names starting with the prefix
+		///
+		/// @param prefix		Prefix of the name (at most 20 chars, NULL removes the criterion)
+		/// @return	the filter, to chain the criteria
+		///
+		ScanFilter& SetNamePrefix(const char* prefix);
+
+		///
+		/// Only matches Peripherals advertising the primary service
+		///
+		/// @param service		UUID of the primary service
+		/// @return	the filter, to chain the criteria
+		///
+		ScanFilter& SetPrimaryService(const UUID& service);
+
+		///
+		/// Only matches Peripherals with at least the RSSI
+		///
+		/// @param rssi			Minimum RSSI [dBm]
+		/// @return	the filter, to chain the criteria
+		///
+		ScanFilter& SetMinimumRssi(int8_t rssi);
+
+		///
+		/// Removes all criteria
+		///
+		void Clear();
+
+		///
+		/// Matches a raw scan line
+		///
+		/// @param line			Scan line without the \r\n
+		/// @return	true if the line is a scan result which matches all criteria
+		///
+		bool Matches(const char* line) const;
+
+	private:
+		enum Criteria
+		{
+			CRITERIA_ADDRESS = 0x01,
+			CRITERIA_NAME = 0x02,
+			CRITERIA_SERVICE = 0x04,
+			CRITERIA_RSSI = 0x08
+		};
+
+		uint8_t m_Criteria;
+
+		char m_Address[13];
+		uint8_t m_AddressLength;
+
+		char m_Name[21];
+		uint8_t m_NameLength;
+
+		// the service as reported: 16 bit (if it is a Bluetooth SIG UUID) and 128 bit
+		char m_ShortService[5];
+		char m_LongService[33];
+
+		int8_t m_MinimumRssi;
+	};
+}
+
+#endif // !SCAN_FILTER_H_
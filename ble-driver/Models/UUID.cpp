@@ -1,100 +1,66 @@
 ﻿#include "UUID.h"
 
 #include <cstring>
-#include <cstdio>
-#include <cstdlib>
 
 namespace Bluetooth
 {
 	const uint8_t MAX_STR_LEN = 37;
 
-	UUID::UUID(const UUID& a_Other): m_ShortUUID(a_Other.m_ShortUUID)
-	{
-		memcpy(m_UUID, a_Other.m_UUID, sizeof(m_UUID));
-	}
-
-	UUID& UUID::operator=(const UUID& a_Other)
-	{
-		if (this == &a_Other)
-			return *this;
-
-		m_ShortUUID = a_Other.m_ShortUUID;
-		memcpy(m_UUID, a_Other.m_UUID, sizeof(m_UUID));
-
-		return *this;
-	}
-
-	UUID::UUID() : m_ShortUUID(-1)
-	{
-		memset(m_UUID, -1, sizeof(m_UUID));
-	}
-
 	UUID::UUID(uint8_t longUUID[]) : m_ShortUUID(longUUID[2] << 8 | longUUID[3])
 	{
 		memcpy(m_UUID, longUUID, sizeof(m_UUID));
 	}
 
-	UUID::UUID(uint16_t shortUUID) : m_ShortUUID(shortUUID)
+	UUID::UUID(const char* hexString) : m_ShortUUID(0)
 	{
-		// 128_bit_value = 16_bit_value * 2^96 + Bluetooth_Base_UUID
-		// Or, to put it more simply, the 16-bit Attribute UUID replaces the x’s in the follow- ing:
-		// 0000xxxx - 0000 - 1000 - 8000 - 00805F9B34FB
+		size_t len = strnlen(hexString, MAX_STR_LEN);
 
-		m_UUID[2] = (shortUUID >> 8) & 0xFF;
-		m_UUID[3] = (shortUUID) & 0xFF;
-	}
-
-	UUID::UUID(const char* hexString)
-	{
-		uint8_t len = strnlen(hexString, MAX_STR_LEN);
-		if (len != 4 && len != 36 && len != 32)
-			return; // invalid
-		
-		// short UUID
-		if (len == 4) 
+		// invalid hex leaves the remaining bytes of the Bluetooth_Base_UUID
+		if (len == 4)
 		{
-			unsigned long value = strtoul(hexString, NULL, 16);
-			m_ShortUUID = static_cast<uint16_t>(value);
-			m_UUID[2] = (m_ShortUUID >> 8) & 0xFF;
-			m_UUID[3] = (m_ShortUUID) & 0xFF;
-
-			return;
+			Util::DecodeHex(hexString, m_UUID + 2, 2);
 		}
-		
-		const char* ptr = hexString;
-		char buf[33] = { 0 };
-
-		// long UUID with seperators
-		if (len == 36)
+		else if (len == 32)
 		{
-			memcpy(buf, hexString, 8);
-			memcpy(buf + 8, hexString + 9, 4);
-			memcpy(buf + 12, hexString + 14, 4);
-			memcpy(buf + 16, hexString + 19, 4);
-			memcpy(buf + 20, hexString + 24, 12);
-
-			ptr = buf;
+			Util::DecodeHex(hexString, m_UUID, sizeof(m_UUID));
 		}
-
-		char tmp[3] = { 0 };
-		for (uint8_t i = 0; i < 32; i += 2)
+		else if (len == 36)
 		{
-			tmp[0] = ptr[i];
-			tmp[1] = ptr[i + 1];
+			// long UUID with seperators (8-4-4-4-12): offset in the string and amount of bytes
+			static const uint8_t SEGMENTS[5][2] = { { 0, 4 }, { 9, 2 }, { 14, 2 }, { 19, 2 }, { 24, 6 } };
+
+			uint8_t* bytes = m_UUID;
+			for (uint8_t i = 0; i < 5; ++i)
+			{
+				if (!Util::DecodeHex(hexString + SEGMENTS[i][0], bytes, SEGMENTS[i][1]))
+					break;
 
-			unsigned long value = strtoul(tmp, NULL, 16);
-			m_UUID[i/2] = static_cast<uint8_t>(value);
+				bytes += SEGMENTS[i][1];
+			}
 		}
 
-		m_ShortUUID = m_UUID[2] << 8 | m_UUID[3];
+		m_ShortUUID = static_cast<uint16_t>(m_UUID[2] << 8 | m_UUID[3]);
+	}
+
+	uint8_t UUID::InvalidLiteral()
+	{
+		// only reached at runtime, the same as an invalid hex string
+		return 0;
 	}
 
 	void UUID::ToCharArray(char* buf, uint8_t len) const
 	{
+		// 8-4-4-4-12 hex digits, the last char stays the null terminator
 		char tmp[MAX_STR_LEN] = { 0 };
-		snprintf(tmp, sizeof(tmp) - 1, "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
-			m_UUID[0], m_UUID[1], m_UUID[2], m_UUID[3], m_UUID[4], m_UUID[5], m_UUID[6], m_UUID[7],
-			m_UUID[8], m_UUID[9], m_UUID[10], m_UUID[11], m_UUID[12], m_UUID[13], m_UUID[14], m_UUID[15]);
+		char* ptr = Util::EncodeHexBytes(m_UUID, 4, tmp);
+		*ptr++ = '-';
+		ptr = Util::EncodeHexBytes(m_UUID + 4, 2, ptr);
+		*ptr++ = '-';
+		ptr = Util::EncodeHexBytes(m_UUID + 6, 2, ptr);
+		*ptr++ = '-';
+		ptr = Util::EncodeHexBytes(m_UUID + 8, 2, ptr);
+		*ptr++ = '-';
+		Util::EncodeHexBytes(m_UUID + 10, 6, ptr);
 
 		strncpy(buf, tmp, len);
 	}
@@ -109,9 +75,31 @@ namespace Bluetooth
 		return m_UUID;
 	}
 
+	uint32_t UUID::GetHash() const
+	{
+		uint64_t words[2];
+		memcpy(words, m_UUID, sizeof(words));
+
+		// the words differ in the first (vendor UUIDs) or only in the second one (SIG UUIDs),
+		// mix both with 2^64 / golden ratio and fold the best mixed upper bits
+		uint64_t hash = (words[0] ^ (words[1] * 0x9E3779B97F4A7C15ULL)) * 0x9E3779B97F4A7C15ULL;
+		return static_cast<uint32_t>(hash >> 32);
+	}
+
 	bool operator==(const UUID& a_Lhs, const UUID& a_Rhs)
 	{
-		return a_Lhs.m_ShortUUID == a_Rhs.m_ShortUUID;
+		// memcpy instead of casting, the bytes may not be aligned (compiles to plain loads)
+		uint64_t lhs[2];
+		uint64_t rhs[2];
+		memcpy(lhs, a_Lhs.m_UUID, sizeof(lhs));
+		memcpy(rhs, a_Rhs.m_UUID, sizeof(rhs));
+
+		return lhs[0] == rhs[0] && lhs[1] == rhs[1];
+	}
+
+	bool operator<(const UUID& a_Lhs, const UUID& a_Rhs)
+	{
+		return memcmp(a_Lhs.m_UUID, a_Rhs.m_UUID, sizeof(a_Lhs.m_UUID)) < 0;
 	}
 
 	bool operator!=(const UUID& a_Lhs, const UUID& a_Rhs)
@@ -1,6 +1,9 @@
 ﻿#ifndef UUID_H_
 #define UUID_H_
 
+#include "../Util/Hex.h"
+
+#include <cstddef>
 #include <inttypes.h>
 
 namespace Bluetooth
@@ -11,7 +14,11 @@ namespace Bluetooth
 		/// 
 		/// Constructs UUID with 0xFF as content
 		/// 
-		UUID();
+		constexpr UUID()
+			: m_UUID{ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },
+			  m_ShortUUID(0xFFFF)
+		{
+		}
 
 		/// 
 		/// Constructs a UUID from the long 128 bit version.
@@ -26,7 +33,11 @@ namespace Bluetooth
 		///
 		/// @param shortUUID		Short UUID to construct with
 		/// 
-		explicit UUID(uint16_t shortUUID);
+		constexpr explicit UUID(uint16_t shortUUID)
+			: m_UUID{ 0x00, 0x00, static_cast<uint8_t>(shortUUID >> 8), static_cast<uint8_t>(shortUUID & 0xFF), 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB },
+			  m_ShortUUID(shortUUID)
+		{
+		}
 
 		/// 
 		/// Constructs a UUID from hex string
@@ -35,14 +46,47 @@ namespace Bluetooth
 		/// 
 		explicit UUID(const char* hexString);
 
-		UUID(const UUID& a_Other);
+		/// 
+		/// Constructs a UUID from hex string at compile time (see the _uuid literal), use
+		/// UUID(const char*) for strings only known at runtime.
+		///
+		/// @param hexString		Hex string of UUID, 4, 32 or 36 (with seperators) chars
+		/// @param len				Length of the string, an invalid string fails to compile when
+		///							constant evaluated (else all bytes are zero)
+		/// 
+		constexpr UUID(const char* hexString, size_t len)
+			: m_UUID{ LiteralByte(hexString, len, 0), LiteralByte(hexString, len, 1), LiteralByte(hexString, len, 2), LiteralByte(hexString, len, 3),
+				LiteralByte(hexString, len, 4), LiteralByte(hexString, len, 5), LiteralByte(hexString, len, 6), LiteralByte(hexString, len, 7),
+				LiteralByte(hexString, len, 8), LiteralByte(hexString, len, 9), LiteralByte(hexString, len, 10), LiteralByte(hexString, len, 11),
+				LiteralByte(hexString, len, 12), LiteralByte(hexString, len, 13), LiteralByte(hexString, len, 14), LiteralByte(hexString, len, 15) },
+			  m_ShortUUID(static_cast<uint16_t>(LiteralByte(hexString, len, 2) << 8 | LiteralByte(hexString, len, 3)))
+		{
+		}
+
+		UUID(const UUID& a_Other) = default;
 
-		UUID& operator=(const UUID& a_Other);
+		UUID& operator=(const UUID& a_Other) = default;
 		
+		/// 
+		/// Compares all 128 bits (as two 64 bit words)
+		/// 
 		friend bool operator==(const UUID& a_Lhs, const UUID& a_Rhs);
 
 		friend bool operator!=(const UUID& a_Lhs, const UUID& a_Rhs);
 
+		/// 
+		/// Orders the UUIDs by their 128 bit value (as written, most significant byte first),
+		/// to use them as key of sorted tables
+		/// 
+		friend bool operator<(const UUID& a_Lhs, const UUID& a_Rhs);
+
+		/// 
+		/// Gets a hash of all 128 bits, to use it as key of hash tables
+		///
+		/// @return				the hash
+		/// 
+		uint32_t GetHash() const;
+
 		/// 
 		/// Gets the short 16 - bit UUID, only valid when constructed from UUID(uint16_t)
 		///
@@ -89,7 +133,52 @@ namespace Bluetooth
 		};
 
 		uint16_t m_ShortUUID;
+
+		// byte of the Bluetooth_Base_UUID
+		static constexpr uint8_t BaseByte(uint8_t index)
+		{
+			return static_cast<uint8_t>("\x00\x00\x00\x00\x00\x00\x10\x00\x80\x00\x00\x80\x5F\x9B\x34\xFB"[index]);
+		}
+
+		// 16 bit, 128 bit or 128 bit with seperators (8-4-4-4-12)
+		static constexpr bool IsLiteralLength(const char* hex, size_t len)
+		{
+			return len == 4 || len == 32 || (len == 36 && hex[8] == '-' && hex[13] == '-' && hex[18] == '-' && hex[23] == '-');
+		}
+
+		// offset of the hex digits of a byte in the literal (skipping the seperators)
+		static constexpr size_t LiteralOffset(size_t len, uint8_t index)
+		{
+			return len == 4 ? (index - 2) * 2
+				: len == 32 ? index * 2
+				: index * 2 + (index >= 4) + (index >= 6) + (index >= 8) + (index >= 10);
+		}
+
+		static constexpr uint8_t LiteralByte(const char* hex, size_t len, uint8_t index)
+		{
+			return !IsLiteralLength(hex, len) ? InvalidLiteral()
+				: len == 4 && index != 2 && index != 3 ? BaseByte(index)
+				: Util::ConstHexPair(hex + LiteralOffset(len, index)) < 0 ? InvalidLiteral()
+				: static_cast<uint8_t>(Util::ConstHexPair(hex + LiteralOffset(len, index)));
+		}
+
+		// not constexpr, so an invalid literal fails to compile when constant evaluated
+		static uint8_t InvalidLiteral();
 	};
+
+	inline namespace Literals
+	{
+		/// 
+		/// UUID built at compile time, e.g. "180F"_uuid or "11223344-5566-7788-9900-AABBCCDDEEFF"_uuid.
+		/// Since C++20 the literal is consteval, so an invalid one always fails to compile. Before
+		/// that it only does in a constant expression (e.g. a constexpr variable), elsewhere it may
+		/// be evaluated at runtime and results in a zero UUID.
+		/// 
+		HEX_LITERAL UUID operator"" _uuid(const char* str, size_t len)
+		{
+			return UUID(str, len);
+		}
+	}
 }
 
 #endif // !UUID_H_
@@ -10,12 +10,13 @@
 namespace Serial
 {
 	/// 
-	/// Seperates Serial messages by a Delimiter. It uses an internal CircularBuffer to store additional
-	/// data if more was received than needed. Make sure that TLen is at least as big as the biggest
+	/// Seperates Serial messages by a Delimiter. It reads ahead from the serial in chunks as large as
+	/// the free space of an internal CircularBuffer, independent of the buffer passed to Receive, and
+	/// hands out the buffered messages one by one. Make sure that TLen is bigger than the biggest
 	/// message. \n
-	/// If TLen is smaller than the delimiter, -1 will be returned and the communication is corrupt. Any
-	/// messages received in that call (and possibly the next) are inrecoverable. To restore from this state
-	/// call Flush to reset the communication.\n
+	/// If a message doesn't fit in TLen, -1 will be returned and the internal buffer is flushed. Any
+	/// messages received in that call (and possibly the next) are inrecoverable. To also drop the data
+	/// pending in the serial device call Flush to reset the communication.\n
 	/// Note that this doesn't fix the state with the connected device which may also have to be restored.
 	///
 	/// @tparam TType			Type to use to hold the indexes (uint8_t, uint16_t ..)
@@ -41,6 +42,15 @@ namespace Serial
 		/// @return				-1 if failed, else the amount of bytes sent	
 		/// 
 		int32_t Send(const char* buffer, uint32_t len) const override;
+
+		/// 
+		/// Sends the buffers followed by the TDelimiter as one vectored send
+		///
+		/// @param buffers		Buffers to send in order (at most MAX_VECTORS)
+		/// @param count		Amount of buffers
+		/// @return				-1 if failed, else the amount of bytes sent
+		/// 
+		int32_t SendVector(const SerialBuffer* buffers, uint8_t count) const override;
 		
 		/// 
 		/// Only sends the buffer directly
@@ -52,16 +62,49 @@ namespace Serial
 		int32_t SendRaw(const char* buffer, uint32_t len) const;
 		
 		/// 
-		/// Receives data from the endpoint and searches for the TDelimiter. If found it stores the 
-		/// data up to the delimiter and stores (if any) additional data in a circular buffer.\n
-		/// If there is data in the circular buffer before calling this, it first fetches it from the
-		/// buffer.
+		/// Receives data from the endpoint into the circular buffer and searches the TDelimiter
+		/// in place. Once found only the line up to the delimiter is copied to the buffer, any
+		/// additional data stays in the circular buffer for the next call.\n
+		/// If the line doesn't fit in the buffer (including the null terminator) it is truncated
+		/// and the remainder of the line is dropped.
 		///
 		/// @param buffer		Buffer to store the data
 		/// @param len			Length of the buffer
-		/// @return				-1 if failed, else the amount of bytes received
+		/// @return				-1 if failed, 0 if no complete (or an empty) line was received, else the length of the line
 		/// 
 		int32_t Receive(char* buffer, uint32_t len) const override;
+
+		/// 
+		/// Receives a line like Receive, but without copying it: line points to the (null
+		/// terminated) line inside the internal buffer, so any length up to TLen - 1 can be
+		/// received. It stays valid until the next receive or flush. The buffered data is only
+		/// moved if the line wraps around the end of the internal buffer.
+		///
+		/// @param line			Pointer to the line
+		/// @return				-1 if failed, 0 if no complete (or an empty) line was received, else the length of the line
+		/// 
+		int32_t ReceiveInPlace(const char** line) const;
+
+		/// 
+		/// Receives a line in place like ReceiveInPlace, but keeps reading until a complete (non
+		/// empty) line has been received or the deadline has passed.
+		///
+		/// @param line			Pointer to the line
+		/// @param deadline		Time up to which to wait
+		/// @return				-1 if failed, 0 if no line was received before the deadline, else the length of the line
+		/// 
+		int32_t ReceiveInPlaceUntil(const char** line, const Util::Deadline& deadline) const;
+
+		/// 
+		/// Receives a line like Receive, but keeps reading until a complete (non empty) line
+		/// has been received or the deadline has passed, also if the line trickles in.
+		///
+		/// @param buffer		Buffer to store the data
+		/// @param len			Length of the buffer
+		/// @param deadline		Time up to which to wait
+		/// @return				-1 if failed, 0 if no line was received before the deadline, else the length of the line
+		/// 
+		int32_t ReceiveUntil(char* buffer, uint32_t len, const Util::Deadline& deadline) const override;
 		
 		/// 
 		/// Receives data from the endpoint and store it in the buffer.
@@ -86,35 +129,73 @@ namespace Serial
 		/// 
 		void Flush(bool internalBufferOnly) const;
 
+		/// 
+		/// Gets the amount of lines which didn't fit in TLen. Such a line also makes a receive
+		/// return -1, but unlike a failure of the serial the next receive can succeed again.
+		///
+		/// @return				amount of overflowed lines since construction
+		/// 
+		uint32_t GetOverflows() const
+		{
+			return m_Overflows;
+		}
+
+		static const uint8_t MAX_VECTORS = 8;
+
 	private:
 		const uint8_t m_DelimiterLength = strlen(TDelimiter);
 		const ISerial& m_Serial;
 
 		mutable Util::CircularBuffer<TType, TLen> m_Circular;
+
+		// amount of bytes in the circular buffer already searched for the delimiter
+		mutable TType m_Searched;
+
+		// the line (and delimiter) handed out by ReceiveInPlace, consumed on the next call
+		mutable TType m_InPlace;
+
+		mutable uint32_t m_Overflows;
+
+		int32_t ReceiveLine(char* buffer, uint32_t len, const Util::Deadline* deadline) const;
+		int32_t ReceiveLineInPlace(const char** line, const Util::Deadline* deadline) const;
+		int32_t FillLine(TType* lineLength, const Util::Deadline* deadline) const;
+		void ReleaseInPlace() const;
+		bool FindDelimiter(TType* lineLength) const;
+		int32_t LoadLine(char* buffer, uint32_t len, TType lineLength) const;
 	};
 
-	template <typename TType = uint32_t, TType TLen, const char* TDelimiter>
+	template <typename TType, TType TLen, const char* TDelimiter>
 	DelimiterSerial<TType, TLen, TDelimiter>::DelimiterSerial(const ISerial& serial) 
-		: m_Serial(serial)
+		: m_Serial(serial), m_Searched(0), m_InPlace(0), m_Overflows(0)
 	{
 	}
 
-	template <typename TType = uint32_t, TType TLen, const char* TDelimiter>
+	template <typename TType, TType TLen, const char* TDelimiter>
 	int32_t DelimiterSerial<TType, TLen, TDelimiter>::Send(const char* buffer, uint32_t len) const
 	{
-		int32_t sent = 0;
 		if (buffer && len > 0)
 		{
-			sent = m_Serial.Send(buffer, len);
-			if (sent == -1)
-				return -1;
+			SerialBuffer line = { buffer, len };
+			return SendVector(&line, 1);
 		}
 
-		int32_t lineSent = m_Serial.Send(TDelimiter, m_DelimiterLength);
-		if (lineSent == -1)
+		return SendVector(NULL, 0);
+	}
+
+	template <typename TType, TType TLen, const char* TDelimiter>
+	int32_t DelimiterSerial<TType, TLen, TDelimiter>::SendVector(const SerialBuffer* buffers, uint8_t count) const
+	{
+		if (count > MAX_VECTORS)
 			return -1;
 
-		return sent + lineSent;
+		SerialBuffer vectors[MAX_VECTORS + 1];
+		for (uint8_t i = 0; i < count; ++i)
+			vectors[i] = buffers[i];
+
+		vectors[count].Data = TDelimiter;
+		vectors[count].Length = m_DelimiterLength;
+
+		return m_Serial.SendVector(vectors, count + 1);
 	}
 
 	template <typename TType, TType TLen, const char* TDelimiter>
@@ -123,7 +204,7 @@ namespace Serial
 		return m_Serial.Send(buffer, len);
 	}
 
-	template <typename TType = uint32_t, TType TLen, const char* TDelimiter>
+	template <typename TType, TType TLen, const char* TDelimiter>
 	void DelimiterSerial<TType, TLen, TDelimiter>::Flush() const
 	{
 		Flush(false);
@@ -133,63 +214,173 @@ namespace Serial
 	void DelimiterSerial<TType, TLen, TDelimiter>::Flush(bool internalBufferOnly) const
 	{
 		m_Circular.Flush();
+		m_Searched = 0;
+		m_InPlace = 0;
 		
 		if (!internalBufferOnly)
 			m_Serial.Flush();
 	}
 
-	template <typename TType = uint32_t, TType TLen, const char* TDelimiter>
+	template <typename TType, TType TLen, const char* TDelimiter>
 	int32_t DelimiterSerial<TType, TLen, TDelimiter>::Receive(char* buffer, uint32_t len) const
 	{
-		int32_t read;
-		char* ptr;
+		return ReceiveLine(buffer, len, NULL);
+	}
+
+	template <typename TType, TType TLen, const char* TDelimiter>
+	int32_t DelimiterSerial<TType, TLen, TDelimiter>::ReceiveInPlace(const char** line) const
+	{
+		return ReceiveLineInPlace(line, NULL);
+	}
 
-		if (m_Circular.GetCount() == 0)
+	template <typename TType, TType TLen, const char* TDelimiter>
+	int32_t DelimiterSerial<TType, TLen, TDelimiter>::ReceiveInPlaceUntil(const char** line, const Util::Deadline& deadline) const
+	{
+		int32_t received;
+		do
 		{
-			read = m_Serial.Receive(buffer, len);
-			if (read < 1)	// nothing received or error
-				return read;
+			received = ReceiveLineInPlace(line, &deadline);
+		} while (received == 0 && !deadline.IsExpired());	// skip empty lines
 
-			ptr = strstr(buffer, TDelimiter);
-			if (ptr == NULL) // not found
-				return -1;
+		return received;
+	}
+
+	template <typename TType, TType TLen, const char* TDelimiter>
+	int32_t DelimiterSerial<TType, TLen, TDelimiter>::ReceiveLineInPlace(const char** line, const Util::Deadline* deadline) const
+	{
+		TType lineLength;
+		int32_t filled = FillLine(&lineLength, deadline);
+		if (filled < 1)
+			return filled;
+
+		// the line and the first byte of the delimiter (replaced by the null terminator) must be contiguous
+		const char* data;
+		if (m_Circular.PeekContiguous(&data) <= lineLength)
+		{
+			m_Circular.Linearize();
+			m_Circular.PeekContiguous(&data);
 		}
-		else
+
+		const_cast<char*>(data)[lineLength] = '\0';
+		m_InPlace = lineLength + m_DelimiterLength;
+
+		*line = data;
+		return lineLength;
+	}
+
+	template <typename TType, TType TLen, const char* TDelimiter>
+	int32_t DelimiterSerial<TType, TLen, TDelimiter>::ReceiveUntil(char* buffer, uint32_t len, const Util::Deadline& deadline) const
+	{
+		int32_t received;
+		do
 		{
-			read = m_Circular.Load(buffer, len);
-			buffer[read] = 0;
+			received = ReceiveLine(buffer, len, &deadline);
+		} while (received == 0 && !deadline.IsExpired());	// skip empty lines
+
+		return received;
+	}
 
-			ptr = strstr(buffer, TDelimiter);
+	template <typename TType, TType TLen, const char* TDelimiter>
+	int32_t DelimiterSerial<TType, TLen, TDelimiter>::ReceiveLine(char* buffer, uint32_t len, const Util::Deadline* deadline) const
+	{
+		TType lineLength;
+		int32_t filled = FillLine(&lineLength, deadline);
+		if (filled < 1)
+			return filled;
 
-			// not found
-			if (ptr == NULL)
+		return LoadLine(buffer, len, lineLength);
+	}
+
+	template <typename TType, TType TLen, const char* TDelimiter>
+	int32_t DelimiterSerial<TType, TLen, TDelimiter>::FillLine(TType* lineLength, const Util::Deadline* deadline) const
+	{
+		ReleaseInPlace();
+
+		while (!FindDelimiter(lineLength))
+		{
+			// the line doesn't fit in our buffer -> data corrupt
+			char* free;
+			TType chunk = m_Circular.ReserveContiguous(&free);
+			if (chunk == 0)
 			{
-				TType left = len - read;
-
-				// there is still room in the target buf, the next call will read data from the
-				// serial device (m_Serial)
-				if (left > 0)
-					return Receive(buffer + read, left);
-				
-				// we already filled the target buffer, we didn't found our delimiter
+				++m_Overflows;
+				Flush(true);
 				return -1;
 			}
+
+			// read ahead as much as fits directly into the circular buffer, regardless of the
+			// length of the target buffer
+			int32_t read = deadline
+				? m_Serial.ReceiveUntil(free, chunk, *deadline)
+				: m_Serial.Receive(free, chunk);
+
+			if (read < 1)	// nothing received (in time) or error
+				return read;
+
+			m_Circular.Commit(static_cast<TType>(read));
 		}
 
-		// calculate how much actual data we have (strip off the delimiter)
-		TType lineLength = ptr - buffer;
-		TType dataLeft = read - lineLength - m_DelimiterLength;
+		return 1;
+	}
+
+	template <typename TType, TType TLen, const char* TDelimiter>
+	void DelimiterSerial<TType, TLen, TDelimiter>::ReleaseInPlace() const
+	{
+		if (m_InPlace == 0)
+			return;
 
-		// store the rest
-		if (dataLeft > 0)
+		m_Circular.Consume(m_InPlace);
+		m_InPlace = 0;
+		m_Searched = 0;
+	}
+
+	template <typename TType, TType TLen, const char* TDelimiter>
+	bool DelimiterSerial<TType, TLen, TDelimiter>::FindDelimiter(TType* lineLength) const
+	{
+		TType count = m_Circular.GetCount();
+		TType offset = m_Searched;
+
+		while ((offset = m_Circular.IndexOf(TDelimiter[0], offset)) < count)
 		{
-			// failed to store all the data in our buffer -> data corrupt
-			if (m_Circular.Store(ptr + m_DelimiterLength, dataLeft) < dataLeft)
-				return -1;
+			// the rest of the delimiter isn't received yet, continue from here next time
+			if (count - offset < m_DelimiterLength)
+			{
+				m_Searched = offset;
+				return false;
+			}
+
+			// compare the rest byte by byte, the delimiter may be split over the wrap
+			uint8_t i = 1;
+			while (i < m_DelimiterLength && m_Circular.Peek(offset + i) == TDelimiter[i])
+				++i;
+
+			if (i == m_DelimiterLength)
+			{
+				*lineLength = offset;
+				return true;
+			}
+
+			++offset;
 		}
 
-		buffer[lineLength] = 0;
-		return lineLength;
+		m_Searched = count;
+		return false;
+	}
+
+	template <typename TType, TType TLen, const char* TDelimiter>
+	int32_t DelimiterSerial<TType, TLen, TDelimiter>::LoadLine(char* buffer, uint32_t len, TType lineLength) const
+	{
+		if (len == 0)
+			return -1;
+
+		// copy as much of the line as fits, drop the rest and the delimiter
+		TType copy = lineLength < len ? lineLength : static_cast<TType>(len - 1);
+		m_Circular.Load(buffer, copy);
+		m_Circular.Consume(lineLength - copy + m_DelimiterLength);
+		m_Searched = 0;
+
+		buffer[copy] = 0;
+		return copy;
 	}
 
 	template <typename TType, TType TLen, const char* TDelimiter>
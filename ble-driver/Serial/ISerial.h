@@ -3,9 +3,20 @@
 
 // libraries
 #include <inttypes.h>
+#include <cstring>
+#include "../Util/Deadline.h"
 
 namespace Serial
 {
+	/// 
+	/// Part of a message sent with ISerial::SendVector
+	/// 
+	struct SerialBuffer
+	{
+		const char* Data;
+		uint32_t Length;
+	};
+
 	class ISerial
 	{
 	public:
@@ -20,6 +31,33 @@ namespace Serial
 		/// 
 		virtual int32_t Send(const char* buffer, uint32_t len) const = 0;
 
+		/// 
+		/// Sends multiple buffers as one message (like writev). The default implementation
+		/// coalesces them into a small stack buffer to send them with a single Send, if they
+		/// don't fit each buffer is sent separately.
+		///
+		/// @param buffers		Buffers to send in order
+		/// @param count		Amount of buffers
+		/// @return				-1 if failed, else the amount of bytes sent
+		/// 
+		virtual int32_t SendVector(const SerialBuffer* buffers, uint8_t count) const
+		{
+			char coalesced[COALESCE_LEN];
+			uint32_t len = 0;
+
+			for (uint8_t i = 0; i < count; ++i)
+			{
+				// too large to coalesce, send them one by one
+				if (len + buffers[i].Length > sizeof(coalesced))
+					return SendSeparately(buffers, count);
+
+				memcpy(coalesced + len, buffers[i].Data, buffers[i].Length);
+				len += buffers[i].Length;
+			}
+
+			return Send(coalesced, len);
+		}
+
 		/// 
 		/// Receives data from the endpoint and store it in the buffer.
 		///
@@ -29,10 +67,51 @@ namespace Serial
 		/// 
 		virtual int32_t Receive(char* buffer, uint32_t len) const = 0;
 
+		/// 
+		/// Receives data like Receive, but keeps waiting until something is received or the
+		/// deadline has passed. The default implementation calls Receive until then, so it may
+		/// overshoot the deadline by the timeout of a single Receive. Implementations which
+		/// can wait for a specific time should override it.
+		///
+		/// @param buffer		Buffer to store the data
+		/// @param len			Length of the buffer
+		/// @param deadline		Time up to which to wait
+		/// @return				-1 if failed, 0 if nothing was received before the deadline, else the amount of bytes received
+		/// 
+		virtual int32_t ReceiveUntil(char* buffer, uint32_t len, const Util::Deadline& deadline) const
+		{
+			do
+			{
+				int32_t received = Receive(buffer, len);
+				if (received != 0)
+					return received;
+			} while (!deadline.IsExpired());
+
+			return 0;
+		}
+
 		/// 
 		/// If serial transmit supports it, flushes the transmit and receive buffers.
 		/// 
 		virtual void Flush() const = 0;
+
+	protected:
+		static const uint32_t COALESCE_LEN = 128;
+
+		int32_t SendSeparately(const SerialBuffer* buffers, uint8_t count) const
+		{
+			int32_t sent = 0;
+			for (uint8_t i = 0; i < count; ++i)
+			{
+				int32_t tmp = Send(buffers[i].Data, buffers[i].Length);
+				if (tmp == -1)
+					return -1;
+
+				sent += tmp;
+			}
+
+			return sent;
+		}
 	};
 }
 #endif // !ISERIAL_H_
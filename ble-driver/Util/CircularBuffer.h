@@ -1,12 +1,17 @@
 #ifndef CIRCULAR_BUFFER_H_
 #define CIRCULAR_BUFFER_H_
 
+#include <algorithm>
+#include <cstring>
+
 namespace Util
 {
 	/// 
 	/// Type for a circular buffer. Note for performance reasons the TLen must be a power of two,
 	/// for calculating the next index a modulo is used, by using a power of two an & operation
-	/// can be used, which is significantly faster than a % operation.
+	/// can be used, which is significantly faster than a % operation.\n
+	/// One byte is kept free to distinguish full from empty, so it holds at most TLen - 1 bytes.
+	/// Store and Load copy the data in at most two memcpy calls (before and after the wrap).
 	///
 	/// @tparam TType		Type to use to hold the indexes (uint8_t, uint16_t ..)
 	/// @tparam TLen		Length of the buffer (must be power of two)
@@ -42,12 +47,74 @@ namespace Util
 		/// 
 		TType Load(char* data, TType len);
 
+		/// 
+		/// Gets a stored byte without removing it from the buffer
+		///
+		/// @param offset		Offset from the oldest byte (must be less than GetCount)
+		/// @return				the byte
+		/// 
+		char Peek(TType offset) const
+		{
+			return m_Buffer[(m_LoadIndex + offset) & MASK];
+		}
+
+		/// 
+		/// Gets the oldest stored data which is contiguous in memory, without copying it. If
+		/// the data wraps around the end of the buffer, call Consume and PeekContiguous again
+		/// to get the remainder.
+		///
+		/// @param data			Pointer to the oldest stored byte
+		/// @return				amount of contiguous bytes at data
+		/// 
+		TType PeekContiguous(const char** data) const;
+
+		/// 
+		/// Moves the stored data to the start of the buffer, so PeekContiguous returns all of
+		/// it. Only moves data if it wraps around the end of the buffer.
+		/// 
+		void Linearize();
+
+		/// 
+		/// Searches the stored data for a byte, without copying it out of the buffer
+		///
+		/// @param value		Byte to search for
+		/// @param offset		Offset from the oldest byte to start searching at
+		/// @return	offset of the first occurrence, GetCount() if not found
+		/// 
+		TType IndexOf(char value, TType offset = 0) const;
+
+		/// 
+		/// Removes data from the buffer without copying it
+		///
+		/// @param len			Amount of bytes to remove
+		/// @return	amount of data removed (can be less than len if insufficient data is stored)
+		/// 
+		TType Consume(TType len);
+
+		/// 
+		/// Gets the free space after the newest stored byte which is contiguous in memory, so
+		/// data can be written (e.g. received) directly into the buffer. Call Commit afterwards
+		/// with the amount of bytes actually written.
+		///
+		/// @param data			Pointer to write the data to
+		/// @return				amount of contiguous bytes free at data
+		/// 
+		TType ReserveContiguous(char** data);
+
+		/// 
+		/// Adds the data written to the pointer returned by ReserveContiguous to the buffer
+		///
+		/// @param len			Amount of bytes written
+		/// @return	amount of data added (can be less than len if insufficient space is available)
+		/// 
+		TType Commit(TType len);
+
 		/// 
 		/// Gets the amount of bytes stored in the buffer
 		///
 		/// @return				bytes stored
 		/// 
-		TType GetCount()
+		TType GetCount() const
 		{
 			return ((m_StoreIndex - m_LoadIndex) & MASK);
 		}
@@ -57,9 +124,9 @@ namespace Util
 		///
 		/// @return				bytes free
 		/// 
-		TType GetFree()
+		TType GetFree() const
 		{
-			return TLen - GetCount();
+			return MASK - GetCount();
 		}
 
 		/// 
@@ -71,7 +138,7 @@ namespace Util
 		TType m_StoreIndex;
 		TType m_LoadIndex;
 		char m_Buffer[TLen];
-		const TType MASK = TLen - 1;
+		static const TType MASK = TLen - 1;
 	};
 
 	template <typename TType, TType TLen>
@@ -84,39 +151,132 @@ namespace Util
 	template <typename TType, TType TLen>
 	TType CircularBuffer<TType, TLen>::Store(const char* data, TType len)
 	{
-		for (TType i = 0; i < len; ++i)
-		{
-			// TLen must be divisable by 2 for our modulo to wrap around fast
-			TType index = (m_StoreIndex + 1) & MASK;
-			if (index == m_LoadIndex)
-				return i; // full
+		TType free = GetFree();
+		if (len > free)
+			len = free; // full
 
-			m_Buffer[m_StoreIndex] = data[i];
-			m_StoreIndex = index;
-		}
+		// first segment up to the end of the buffer, second one from the start
+		TType first = TLen - m_StoreIndex;
+		if (first > len)
+			first = len;
 
+		memcpy(m_Buffer + m_StoreIndex, data, first);
+		memcpy(m_Buffer, data + first, len - first);
+
+		m_StoreIndex = (m_StoreIndex + len) & MASK;
 		return len;
 	}
 
 	template <typename TType, TType TLen>
 	TType CircularBuffer<TType, TLen>::Load(char* data, TType len)
 	{
-		TType index = m_LoadIndex;
-		TType i;
+		TType count = GetCount();
+		if (len > count)
+			len = count; // empty
 
-		for (i = 0; i < len; ++i)
-		{
-			if (m_StoreIndex == index)
-				break; // empty
+		TType first = TLen - m_LoadIndex;
+		if (first > len)
+			first = len;
 
-			data[i] = m_Buffer[index];
-			m_Buffer[index] = 0xFF; // debugging only
-			++index &= MASK;
-		}
+		memcpy(data, m_Buffer + m_LoadIndex, first);
+		memcpy(data + first, m_Buffer, len - first);
 
-		m_LoadIndex = index;
+		return Consume(len);
+	}
 
-		return i;
+	template <typename TType, TType TLen>
+	TType CircularBuffer<TType, TLen>::PeekContiguous(const char** data) const
+	{
+		*data = m_Buffer + m_LoadIndex;
+
+		// the stored data either ends before the store index or at the end of the buffer
+		if (m_StoreIndex >= m_LoadIndex)
+			return m_StoreIndex - m_LoadIndex;
+
+		return TLen - m_LoadIndex;
+	}
+
+	template <typename TType, TType TLen>
+	void CircularBuffer<TType, TLen>::Linearize()
+	{
+		if (m_StoreIndex >= m_LoadIndex)
+			return;
+
+		// rotating the whole buffer keeps the order of the stored (and free) bytes
+		TType count = GetCount();
+		std::rotate(m_Buffer, m_Buffer + m_LoadIndex, m_Buffer + TLen);
+
+		m_LoadIndex = 0;
+		m_StoreIndex = count;
+	}
+
+	template <typename TType, TType TLen>
+	TType CircularBuffer<TType, TLen>::ReserveContiguous(char** data)
+	{
+		*data = m_Buffer + m_StoreIndex;
+
+		// free space either ends before the load index or at the end of the buffer (keeping
+		// one byte free when the load index is at the start)
+		if (m_StoreIndex < m_LoadIndex)
+			return m_LoadIndex - m_StoreIndex - 1;
+
+		return TLen - m_StoreIndex - (m_LoadIndex == 0 ? 1 : 0);
+	}
+
+	template <typename TType, TType TLen>
+	TType CircularBuffer<TType, TLen>::Commit(TType len)
+	{
+		TType free = GetFree();
+		if (len > free)
+			len = free;
+
+		m_StoreIndex = (m_StoreIndex + len) & MASK;
+		return len;
+	}
+
+	template <typename TType, TType TLen>
+	TType CircularBuffer<TType, TLen>::IndexOf(char value, TType offset) const
+	{
+		TType count = GetCount();
+		if (offset >= count)
+			return count;
+
+		// search the part up to the end of the buffer, then the wrapped part
+		TType start = (m_LoadIndex + offset) & MASK;
+		TType first = TLen - start;
+		if (first > count - offset)
+			first = count - offset;
+
+		const char* found = static_cast<const char*>(memchr(m_Buffer + start, value, first));
+		if (found)
+			return offset + static_cast<TType>(found - (m_Buffer + start));
+
+		found = static_cast<const char*>(memchr(m_Buffer, value, count - offset - first));
+		if (found)
+			return offset + first + static_cast<TType>(found - m_Buffer);
+
+		return count;
+	}
+
+	template <typename TType, TType TLen>
+	TType CircularBuffer<TType, TLen>::Consume(TType len)
+	{
+		TType count = GetCount();
+		if (len > count)
+			len = count;
+
+#ifndef NDEBUG
+		// debugging only, makes consumed data recognizable
+		TType first = TLen - m_LoadIndex;
+		if (first > len)
+			first = len;
+
+		memset(m_Buffer + m_LoadIndex, 0xFF, first);
+		memset(m_Buffer, 0xFF, len - first);
+#endif
+
+		m_LoadIndex = (m_LoadIndex + len) & MASK;
+		return len;
 	}
 
 	template <typename TType, TType TLen>
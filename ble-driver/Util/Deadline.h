@@ -0,0 +1,79 @@
+#ifndef DEADLINE_H_
+#define DEADLINE_H_
+
+// std libraries
+#include <chrono>
+#include <inttypes.h>
+
+namespace Util
+{
+	///
+	/// Point in time on the monotonic clock up to which an operation may wait. Unlike a
+	/// count of retries the real waiting time doesn't depend on the timeout of the
+	/// underlying serial, so a chain of receives is bound by a single time budget.
+	///
+	class Deadline
+	{
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		///
+		/// Constructs a deadline which expires after the timeout
+		///
+		/// @param timeout		Time budget from now [ms]
+		///
+		explicit Deadline(uint32_t timeout)
+			: m_Expiry(Clock::now() + std::chrono::milliseconds(timeout))
+		{
+		}
+
+		///
+		/// Constructs a deadline which expires at the point in time
+		///
+		/// @param expiry		Point in time on Clock
+		///
+		explicit Deadline(Clock::time_point expiry)
+			: m_Expiry(expiry)
+		{
+		}
+
+		///
+		/// Checks if the deadline has passed
+		///
+		/// @return	true if no time is left
+		///
+		bool IsExpired() const
+		{
+			return Clock::now() >= m_Expiry;
+		}
+
+		///
+		/// Gets the time left until the deadline, rounded up so that waiting the remaining
+		/// time never returns before the deadline has passed
+		///
+		/// @return	remaining time [ms], 0 if expired
+		///
+		uint32_t GetRemaining() const
+		{
+			Clock::duration left = m_Expiry - Clock::now();
+			if (left <= Clock::duration::zero())
+				return 0;
+
+			std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(left);
+			if (ms < left)
+				ms += std::chrono::milliseconds(1);
+
+			return static_cast<uint32_t>(ms.count());
+		}
+
+		Clock::time_point GetExpiry() const
+		{
+			return m_Expiry;
+		}
+
+	private:
+		Clock::time_point m_Expiry;
+	};
+}
+
+#endif // !DEADLINE_H_
@@ -0,0 +1,62 @@
+#include "Hex.h"
+
+namespace Util
+{
+	const int8_t g_HexDecodeTable[256] =
+	{
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1,
+		-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+	};
+
+	bool DecodeHex(const char* hex, uint8_t* bytes, uint32_t len)
+	{
+		for (uint32_t i = 0; i < len; ++i)
+		{
+			// also stops at the null terminator, before reading past it
+			int8_t high = HexValue(hex[2 * i]);
+			if (high < 0)
+				return false;
+
+			int8_t low = HexValue(hex[2 * i + 1]);
+			if (low < 0)
+				return false;
+
+			bytes[i] = static_cast<uint8_t>(high << 4 | low);
+		}
+
+		return true;
+	}
+
+	uint8_t ParseHex(const char* hex, uint32_t* value, uint8_t maxDigits)
+	{
+		if (maxDigits > 8)
+			maxDigits = 8;
+
+		uint32_t result = 0;
+		uint8_t digits = 0;
+
+		int8_t nibble;
+		while (digits < maxDigits && (nibble = HexValue(hex[digits])) >= 0)
+		{
+			result = result << 4 | nibble;
+			++digits;
+		}
+
+		*value = result;
+		return digits;
+	}
+}
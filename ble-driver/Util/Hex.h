@@ -0,0 +1,144 @@
+#ifndef HEX_H_
+#define HEX_H_
+
+#include <inttypes.h>
+
+// literals (e.g. _uuid and _mac) which must be evaluated at compile time, before C++20 they
+// are only forced to be when used in a constant expression
+#ifdef __cpp_consteval
+#define HEX_LITERAL consteval
+#else
+#define HEX_LITERAL constexpr
+#endif
+
+namespace Util
+{
+	/// 
+	/// Value of each ASCII character as hex digit, -1 if it isn't a hex digit
+	/// 
+	extern const int8_t g_HexDecodeTable[256];
+
+	/// 
+	/// Uppercase hex digit of each nibble value
+	/// 
+	static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+	/// 
+	/// Encodes a value as fixed width uppercase hex (e.g. 0x1A in 4 digits to "001A"), a
+	/// replacement of snprintf("%0*X") without parsing a format or locale. It doesn't write a
+	/// null terminator.
+	///
+	/// @param value		Value to encode
+	/// @param digits		Amount of digits to write (at most 8, the upper digits are zero)
+	/// @param hex			Output of at least digits characters
+	/// @return	pointer after the last written digit
+	/// 
+	inline char* EncodeHex(uint32_t value, uint8_t digits, char* hex)
+	{
+		for (uint8_t i = digits; i > 0; --i)
+		{
+			hex[i - 1] = HEX_DIGITS[value & 0x0F];
+			value >>= 4;
+		}
+
+		return hex + digits;
+	}
+
+	/// 
+	/// Encodes bytes as pairs of uppercase hex digits (e.g. { 0x1E, 0xC0 } to "1EC0"). It
+	/// doesn't write a null terminator.
+	///
+	/// @param bytes		Bytes to encode
+	/// @param len			Amount of bytes to encode
+	/// @param hex			Output of at least 2 * len characters
+	/// @return	pointer after the last written digit
+	/// 
+	inline char* EncodeHexBytes(const uint8_t* bytes, uint32_t len, char* hex)
+	{
+		for (uint32_t i = 0; i < len; ++i)
+		{
+			*hex++ = HEX_DIGITS[bytes[i] >> 4];
+			*hex++ = HEX_DIGITS[bytes[i] & 0x0F];
+		}
+
+		return hex;
+	}
+
+	/// 
+	/// Gets the value of a hex digit (0-9, a-f, A-F)
+	///
+	/// @param c			Character to decode
+	/// @return	the value 0 up to 15, -1 if the character isn't a hex digit
+	/// 
+	inline int8_t HexValue(char c)
+	{
+		return g_HexDecodeTable[static_cast<uint8_t>(c)];
+	}
+
+	/// 
+	/// Gets the value of a hex digit at compile time, use HexValue at runtime
+	///
+	/// @param c			Character to decode
+	/// @return	the value 0 up to 15, -1 if the character isn't a hex digit
+	/// 
+	constexpr int8_t ConstHexValue(char c)
+	{
+		return c >= '0' && c <= '9' ? static_cast<int8_t>(c - '0')
+			: c >= 'a' && c <= 'f' ? static_cast<int8_t>(c - 'a' + 10)
+			: c >= 'A' && c <= 'F' ? static_cast<int8_t>(c - 'A' + 10)
+			: -1;
+	}
+
+	/// 
+	/// Decodes a pair of hex digits (e.g. "1E" to 0x1E) at compile time
+	///
+	/// @param hex			Hex string of at least 2 characters
+	/// @return	the byte, -1 if one of the characters isn't a hex digit
+	/// 
+	constexpr int16_t ConstHexPair(const char* hex)
+	{
+		return ConstHexValue(hex[0]) < 0 || ConstHexValue(hex[1]) < 0 ? -1 : static_cast<int16_t>(ConstHexValue(hex[0]) << 4 | ConstHexValue(hex[1]));
+	}
+
+	/// 
+	/// Decodes pairs of hex digits into bytes (e.g. "1EC0" to { 0x1E, 0xC0 })
+	///
+	/// @param hex			Hex string of at least 2 * len characters
+	/// @param bytes		Output of the decoded bytes
+	/// @param len			Amount of bytes to decode
+	/// @return	false if one of the characters isn't a hex digit
+	/// 
+	bool DecodeHex(const char* hex, uint8_t* bytes, uint32_t len);
+
+	/// 
+	/// Parses a hex number up to the first non hex digit
+	///
+	/// @param hex			Hex string to parse
+	/// @param value		Output of the parsed value
+	/// @param maxDigits	Maximum amount of digits to parse (at most 8)
+	/// @return	amount of digits parsed, 0 if it doesn't start with a hex digit
+	/// 
+	uint8_t ParseHex(const char* hex, uint32_t* value, uint8_t maxDigits = 8);
+
+	/// 
+	/// Decodes pairs of hex digits into a buffer, like DecodeHex, but 16 bytes at a time with
+	/// SSE2 when the CPU supports it. Unlike DecodeHex it reads blocks of characters, so all
+	/// 2 * len characters must be readable (it doesn't stop at a null terminator).
+	///
+	/// @param hex			Hex string of at least 2 * len characters
+	/// @param bytes		Output of the decoded bytes
+	/// @param len			Amount of bytes to decode
+	/// @return	false if one of the characters isn't a hex digit
+	/// 
+	bool DecodeHexBuffer(const char* hex, uint8_t* bytes, uint32_t len);
+
+	/// 
+	/// Gets the name of the kernel used by DecodeHexBuffer, selected on the first call for the
+	/// CPU it runs on
+	///
+	/// @return	"sse2" or "scalar"
+	/// 
+	const char* HexBufferKernel();
+}
+
+#endif // !HEX_H_
@@ -0,0 +1,99 @@
+#include "Hex.h"
+
+// SSE2 is part of every x64 CPU, on 32 bit x86 it is checked at runtime (MSVC can use the
+// intrinsics without /arch:SSE2, GCC and Clang only when compiled with -msse2)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define HEX_BUFFER_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER) && defined(_M_IX86)
+#include <intrin.h>
+#endif
+#endif
+
+namespace
+{
+	typedef bool (*DecodeFunction)(const char* hex, uint8_t* bytes, uint32_t len);
+
+	bool decodeScalar(const char* hex, uint8_t* bytes, uint32_t len)
+	{
+		return Util::DecodeHex(hex, bytes, len);
+	}
+
+#ifdef HEX_BUFFER_SSE2
+	bool hasSse2()
+	{
+#if defined(_MSC_VER) && defined(_M_IX86)
+		// EDX bit 26 of leaf 1
+		int info[4];
+		__cpuid(info, 1);
+		return (info[3] & (1 << 26)) != 0;
+#else
+		return true;
+#endif
+	}
+
+	// '0'-'9', 'a'-'f' and 'A'-'F' to nibbles, clears the bytes of valid for other characters
+	__m128i hexToNibbles(__m128i hex, __m128i* valid)
+	{
+		// the signed compares also reject characters above 0x7F, as they wrap to negative
+		__m128i digit = _mm_sub_epi8(hex, _mm_set1_epi8('0'));
+		__m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(digit, _mm_set1_epi8(-1)), _mm_cmplt_epi8(digit, _mm_set1_epi8(10)));
+
+		// lowercase, then 'a' to 0
+		__m128i letter = _mm_sub_epi8(_mm_or_si128(hex, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+		__m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(letter, _mm_set1_epi8(-1)), _mm_cmplt_epi8(letter, _mm_set1_epi8(6)));
+
+		*valid = _mm_and_si128(*valid, _mm_or_si128(isDigit, isLetter));
+		return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+	}
+
+	// pairs of nibbles (high first) to a byte in the low half of each 16 bit lane
+	__m128i joinNibbles(__m128i nibbles)
+	{
+		__m128i high = _mm_and_si128(_mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0x00F0));
+		return _mm_or_si128(high, _mm_srli_epi16(nibbles, 8));
+	}
+
+	bool decodeSse2(const char* hex, uint8_t* bytes, uint32_t len)
+	{
+		for (; len >= 16; len -= 16, hex += 32, bytes += 16)
+		{
+			__m128i valid = _mm_set1_epi8(-1);
+			__m128i first = hexToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex)), &valid);
+			__m128i second = hexToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 16)), &valid);
+
+			if (_mm_movemask_epi8(valid) != 0xFFFF)
+				return false;
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), _mm_packus_epi16(joinNibbles(first), joinNibbles(second)));
+		}
+
+		return Util::DecodeHex(hex, bytes, len);
+	}
+#endif
+
+	// selected on the first call instead of during static initialisation, so it can also be
+	// used from the static initialisers of other translation units
+	DecodeFunction decodeBuffer()
+	{
+#ifdef HEX_BUFFER_SSE2
+		static const DecodeFunction decode = hasSse2() ? decodeSse2 : decodeScalar;
+		return decode;
+#else
+		return decodeScalar;
+#endif
+	}
+}
+
+namespace Util
+{
+	bool DecodeHexBuffer(const char* hex, uint8_t* bytes, uint32_t len)
+	{
+		return decodeBuffer()(hex, bytes, len);
+	}
+
+	const char* HexBufferKernel()
+	{
+		return decodeBuffer() == decodeScalar ? "scalar" : "sse2";
+	}
+}
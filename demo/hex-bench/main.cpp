@@ -0,0 +1,145 @@
+// user libraries
+#include "Util/Hex.h"
+#include "Models/MACAddress.h"
+#include "Models/UUID.h"
+
+// std libraries
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using namespace Bluetooth;
+
+namespace
+{
+	const uint32_t ITERATIONS = 1000000;
+
+	// keeps the compiler from removing the formatting
+	volatile char g_Sink;
+
+	template <typename TFormat>
+	double measure(TFormat format)
+	{
+		char buf[64] = { 0 };
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (uint32_t i = 0; i < ITERATIONS; ++i)
+		{
+			format(buf, i);
+			g_Sink = buf[i & 0x0F];
+		}
+
+		chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+		return elapsed.count() / ITERATIONS;
+	}
+
+	template <typename TOld, typename TNew>
+	void compare(const char* name, TOld old, TNew table, const char* oldName = "snprintf", const char* newName = "table")
+	{
+		// both must give the same string
+		char expected[64] = { 0 };
+		char actual[64] = { 0 };
+		old(expected, 0x1234ABCD);
+		table(actual, 0x1234ABCD);
+
+		if (strcmp(expected, actual) != 0)
+		{
+			cout << name << ": mismatch " << expected << " != " << actual << endl;
+			return;
+		}
+
+		double oldNs = measure(old);
+		double newNs = measure(table);
+
+		printf("%-24s %-8s %7.1f ns   %-6s %7.1f ns   %5.1fx\n", name, oldName, oldNs, newName, newNs, oldNs / newNs);
+	}
+}
+
+int main()
+{
+	cout << "hex encoding, " << ITERATIONS << " iterations each" << endl;
+
+	// SHW,001A,1234ABCD (e.g. WriteServerCharacteristicValue with uint32_t)
+	compare("handle,uint32",
+		[](char* buf, uint32_t i) { snprintf(buf, 14, "%04X,%0*X", i & 0xFFFF, 8, i); },
+		[](char* buf, uint32_t i)
+		{
+			char* ptr = Util::EncodeHex(i & 0xFFFF, 4, buf);
+			*ptr++ = ',';
+			*Util::EncodeHex(i, 8, ptr) = '\0';
+		});
+
+	// SS,C0000000 (SetHex32)
+	compare("uint32",
+		[](char* buf, uint32_t i) { snprintf(buf, 9, "%08X", i); },
+		[](char* buf, uint32_t i) { *Util::EncodeHex(i, 8, buf) = '\0'; });
+
+	// N,... (Broadcast with the full 25 bytes)
+	compare("advertisement (25 bytes)",
+		[](char* buf, uint32_t i)
+		{
+			uint8_t data[25];
+			memset(data, i & 0xFF, sizeof(data));
+			for (uint8_t j = 0; j < sizeof(data); ++j)
+				snprintf(buf + j * 2, 3, "%02X", data[j]);
+		},
+		[](char* buf, uint32_t i)
+		{
+			uint8_t data[25];
+			memset(data, i & 0xFF, sizeof(data));
+			*Util::EncodeHexBytes(data, sizeof(data), buf) = '\0';
+		});
+
+	// the MAC Address of every scan result
+	compare("MAC Address",
+		[](char* buf, uint32_t i)
+		{
+			uint8_t bytes[6] = { 0x00, 0x1E, 0xC0, 0x1A, 0x2B, static_cast<uint8_t>(i) };
+			for (uint8_t j = 0; j < 6; ++j)
+				snprintf(buf + j * 2, 3, "%02X", bytes[j]);
+		},
+		[](char* buf, uint32_t i)
+		{
+			uint8_t bytes[6] = { 0x00, 0x1E, 0xC0, 0x1A, 0x2B, static_cast<uint8_t>(i) };
+			MACAddress(bytes).ToCharArray(buf, 13, '\0');
+		});
+
+	// 128 bit UUID with seperators
+	compare("UUID",
+		[](char* buf, uint32_t i)
+		{
+			uint8_t u[16] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0x00, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, static_cast<uint8_t>(i) };
+			snprintf(buf, 37, "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+				u[0], u[1], u[2], u[3], u[4], u[5], u[6], u[7], u[8], u[9], u[10], u[11], u[12], u[13], u[14], u[15]);
+		},
+		[](char* buf, uint32_t i)
+		{
+			uint8_t u[16] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0x00, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, static_cast<uint8_t>(i) };
+			UUID(u).ToCharArray(buf, 37);
+		});
+
+	// values read from a characteristic (DecodeHexBuffer), the scalar table against the
+	// kernel selected for this CPU
+	cout << endl << "buffers, " << Util::HexBufferKernel() << " kernel" << endl;
+
+	compare("decode 20 byte value",
+		[](char* buf, uint32_t i)
+		{
+			static const char hex[] = "00112233445566778899AABBCCDDEEFF0123ABCD";
+			uint8_t data[20];
+			Util::DecodeHex(hex, data, sizeof(data));
+			*Util::EncodeHex(data[i % sizeof(data)], 2, buf) = '\0';
+		},
+		[](char* buf, uint32_t i)
+		{
+			static const char hex[] = "00112233445566778899AABBCCDDEEFF0123ABCD";
+			uint8_t data[20];
+			Util::DecodeHexBuffer(hex, data, sizeof(data));
+			*Util::EncodeHex(data[i % sizeof(data)], 2, buf) = '\0';
+		},
+		"scalar", "kernel");
+
+	return 0;
+}
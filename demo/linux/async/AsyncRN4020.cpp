@@ -0,0 +1,250 @@
+#include "AsyncRN4020.h"
+
+// std libraries
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+using namespace Bluetooth;
+using namespace Bluetooth::Drivers;
+
+namespace
+{
+	// the module needs about a second to boot after R,1
+	const uint32_t REBOOT_TIMEOUT = 2000;
+}
+
+namespace Async
+{
+	AsyncRN4020::AsyncRN4020(EventLoop& loop, Serial::Linux::LinuxSerialPort& port)
+		: m_Loop(loop),
+		  m_Port(port),
+		  m_Lines(port),
+		  m_ResponseTimeout(500)
+	{
+		// the loop tells when the port is readable, reads should never wait
+		m_Port.SetReceiveTimeout(0);
+		m_Loop.Watch(m_Port.GetFileDescriptor(), OnReadable, this);
+	}
+
+	AsyncRN4020::~AsyncRN4020()
+	{
+		m_Loop.Unwatch(m_Port.GetFileDescriptor());
+	}
+
+	Task<bool> AsyncRN4020::AsyncSet(const char* command, const char* param)
+	{
+		if (!RN4020Driver::SendCommand(m_Lines, command, param))
+			co_return false;
+
+		char buf[8];
+		int32_t received = co_await WaitLine(FILTER_STATUS, buf, sizeof(buf), m_ResponseTimeout);
+
+		co_return received > 0 && RN4020Driver::ClassifyLine(buf) == RN4020Driver::LINE_AOK;
+	}
+
+	Task<bool> AsyncRN4020::AsyncGet(const char* command, char* buf, uint32_t len)
+	{
+		if (!RN4020Driver::SendCommand(m_Lines, command, NULL))
+			co_return false;
+
+		int32_t received = co_await WaitLine(FILTER_VALUE, buf, len, m_ResponseTimeout);
+
+		co_return received > 0 && RN4020Driver::ClassifyLine(buf) != RN4020Driver::LINE_ERR;
+	}
+
+	Task<bool> AsyncRN4020::AsyncSetName(const char* name)
+	{
+		return AsyncSet("SN", name);
+	}
+
+	Task<bool> AsyncRN4020::AsyncGetName(char* name, uint8_t len)
+	{
+		return AsyncGet("GN", name, len);
+	}
+
+	Task<bool> AsyncRN4020::AsyncSetServices(uint32_t services)
+	{
+		char buf[10] = { 0 };
+		Util::EncodeHex(services, 8, buf);
+
+		co_return co_await AsyncSet("SS", buf);
+	}
+
+	Task<bool> AsyncRN4020::AsyncSetFeatures(uint32_t features)
+	{
+		char buf[10] = { 0 };
+		Util::EncodeHex(features, 8, buf);
+
+		co_return co_await AsyncSet("SR", buf);
+	}
+
+	Task<bool> AsyncRN4020::AsyncReboot()
+	{
+		char buf[8];
+		if (!co_await AsyncGet("R,1", buf, sizeof(buf)))
+			co_return false;
+
+		int32_t received = co_await WaitLine(FILTER_CMD, buf, sizeof(buf), REBOOT_TIMEOUT);
+		co_return received > 0;
+	}
+
+	Task<uint8_t> AsyncRN4020::AsyncScan(BluetoothLEPeripheral* devices, uint8_t len, uint32_t timeout)
+	{
+		if (!co_await AsyncSet("F", NULL))
+			co_return 0;
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+		char line[LINE_LEN];
+		uint8_t index = 0;
+		while (index < len)
+		{
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+			if (remaining <= 0)
+				break;
+
+			if (co_await WaitLine(FILTER_SCAN, line, sizeof(line), static_cast<uint32_t>(remaining)) <= 0)
+				break;
+
+			if (RN4020Driver::ParseScanLine(line, devices + index))
+				++index;
+		}
+
+		// the scan results still coming in are skipped while waiting for AOK
+		co_await AsyncSet("X", NULL);
+		co_return index;
+	}
+
+	Task<bool> AsyncRN4020::AsyncConnect(const BluetoothLEPeripheral& peripheral, uint32_t timeout)
+	{
+		char buf[15] = { peripheral.GetIsRandomMAC() ? '1' : '0', ',' };
+		peripheral.GetMACAddress().ToCharArray(buf + 2, 13, '\0');
+
+		if (!co_await AsyncSet("E", buf))
+			co_return false;
+
+		char line[16];
+		if (co_await WaitLine(FILTER_CONNECTED, line, sizeof(line), timeout) > 0)
+			co_return true;
+
+		// give up connecting
+		co_await AsyncSet("Z", NULL);
+		co_return false;
+	}
+
+	AsyncRN4020::LineAwaiter AsyncRN4020::WaitLine(LineFilter filter, char* buf, uint32_t len, uint32_t timeout)
+	{
+		return LineAwaiter(*this, filter, buf, len, timeout);
+	}
+
+	void AsyncRN4020::OnReadable(void* context)
+	{
+		AsyncRN4020* module = static_cast<AsyncRN4020*>(context);
+
+		char line[LINE_LEN];
+		uint8_t idle = 0;
+
+		// an empty line also returns 0, so only stop when nothing was received twice
+		while (idle < 2)
+		{
+			int32_t received = module->m_Lines.Receive(line, sizeof(line));
+			if (received == -1)
+				break;
+
+			if (received == 0)
+			{
+				++idle;
+				continue;
+			}
+
+			idle = 0;
+
+			// the response of a command which timed out comes before the ones of later commands
+			if (!module->m_Late.empty() && Matches(module->m_Late.front(), line))
+			{
+				module->m_Late.pop_front();
+				continue;
+			}
+
+			// lines nobody waits for (or which the oldest waiter skips) are dropped
+			if (module->m_Waiting.empty())
+				continue;
+
+			LineAwaiter* awaiter = module->m_Waiting.front();
+			if (!awaiter->Offer(line, received))
+				continue;
+
+			module->m_Waiting.pop_front();
+			module->m_Loop.CancelTimer(awaiter->m_Timer);
+			awaiter->m_Handle.resume();
+		}
+	}
+
+	bool AsyncRN4020::Matches(LineFilter filter, const char* line)
+	{
+		// the same matching as the (blocking) driver
+		RN4020Driver::LineType type = RN4020Driver::ClassifyLine(line);
+
+		switch (filter)
+		{
+		case FILTER_STATUS:
+			return type == RN4020Driver::LINE_AOK || type == RN4020Driver::LINE_ERR;
+		case FILTER_SCAN:
+			return type == RN4020Driver::LINE_SCAN;
+		case FILTER_CONNECTED:
+			return type == RN4020Driver::LINE_CONNECTED;
+		case FILTER_CMD:
+			return type == RN4020Driver::LINE_CMD;
+		default:
+			return type == RN4020Driver::LINE_OTHER || type == RN4020Driver::LINE_ERR;
+		}
+	}
+
+	AsyncRN4020::LineAwaiter::LineAwaiter(AsyncRN4020& module, LineFilter filter, char* buf, uint32_t len, uint32_t timeout)
+		: m_Module(module),
+		  m_Filter(filter),
+		  m_Buffer(buf),
+		  m_Length(len),
+		  m_Timeout(timeout),
+		  m_Received(0),
+		  m_Timer(0)
+	{
+	}
+
+	void AsyncRN4020::LineAwaiter::await_suspend(std::coroutine_handle<> handle)
+	{
+		m_Handle = handle;
+		m_Module.m_Waiting.push_back(this);
+		m_Timer = m_Module.m_Loop.AddTimer(m_Timeout, OnTimeout, this);
+	}
+
+	bool AsyncRN4020::LineAwaiter::Offer(const char* line, int32_t len)
+	{
+		if (!Matches(m_Filter, line))
+			return false;
+
+		// truncate to the buffer (including the null terminator)
+		uint32_t copy = std::min(static_cast<uint32_t>(len), m_Length - 1);
+		memcpy(m_Buffer, line, copy);
+		m_Buffer[copy] = '\0';
+
+		m_Received = copy;
+		return true;
+	}
+
+	void AsyncRN4020::LineAwaiter::OnTimeout(void* context)
+	{
+		LineAwaiter* awaiter = static_cast<LineAwaiter*>(context);
+
+		std::deque<LineAwaiter*>& waiting = awaiter->m_Module.m_Waiting;
+		waiting.erase(std::remove(waiting.begin(), waiting.end(), awaiter), waiting.end());
+
+		// only the response of the command is still on its way, a missed scan result or status isn't
+		if (awaiter->m_Filter == FILTER_STATUS || awaiter->m_Filter == FILTER_VALUE)
+			awaiter->m_Module.m_Late.push_back(awaiter->m_Filter);
+
+		awaiter->m_Received = 0;
+		awaiter->m_Handle.resume();
+	}
+}
@@ -0,0 +1,169 @@
+#ifndef ASYNC_RN4020_H_
+#define ASYNC_RN4020_H_
+
+// user libraries
+#include "EventLoop.h"
+#include "Task.h"
+#include "LinuxSerialPort.h"
+#include "Drivers/RN4020Driver.h"
+
+// std libraries
+#include <deque>
+
+namespace Async
+{
+	///
+	/// Awaitable RN4020 commands driven by an EventLoop, so a single thread can drive many
+	/// modules with many commands in flight:
+	/// \code
+	/// Task<void> provision(AsyncRN4020& module)
+	/// {
+	///     if (co_await module.AsyncSetName("Sensor"))
+	///         co_await module.AsyncReboot();
+	/// }
+	/// \endcode
+	/// The responses of a module are matched in order with the awaiting commands, the late
+	/// response of a command which timed out is dropped when it arrives. Multiple
+	/// commands may be awaited at the same time, but a multi step operation (a scan or a
+	/// connect) should not be interleaved with other commands of the same module.
+	///
+	class AsyncRN4020
+	{
+	public:
+		///
+		/// Constructs the module and starts watching the port
+		///
+		/// @param loop			Loop to run the commands on
+		/// @param port			Opened port connected to the module, its receive timeout is set to 0
+		///
+		AsyncRN4020(EventLoop& loop, Serial::Linux::LinuxSerialPort& port);
+		~AsyncRN4020();
+
+		AsyncRN4020(const AsyncRN4020&) = delete;
+		AsyncRN4020& operator=(const AsyncRN4020&) = delete;
+
+		///
+		/// Sets the maximum time to wait for a response
+		///
+		/// @param timeout		Timeout [ms]
+		///
+		void SetResponseTimeout(uint32_t timeout)
+		{
+			m_ResponseTimeout = timeout;
+		}
+
+		///
+		/// Sends a command (command[,param]) and awaits AOK or ERR
+		///
+		/// @param command		Command to send
+		/// @param param		Parameter of the command (may be NULL)
+		/// @return				true if AOK was received
+		///
+		Task<bool> AsyncSet(const char* command, const char* param);
+
+		///
+		/// Sends a command and awaits the value it answers with
+		///
+		/// @param command		Command to send
+		/// @param buf			Buffer for the value
+		/// @param len			Length of buffer
+		/// @return				true if a value (not ERR) was received
+		///
+		Task<bool> AsyncGet(const char* command, char* buf, uint32_t len);
+
+		Task<bool> AsyncSetName(const char* name);
+		Task<bool> AsyncGetName(char* name, uint8_t len);
+		Task<bool> AsyncSetServices(uint32_t services);
+		Task<bool> AsyncSetFeatures(uint32_t features);
+
+		///
+		/// Reboots the module and awaits CMD
+		///
+		/// @return				true if the module is back in command mode
+		///
+		Task<bool> AsyncReboot();
+
+		///
+		/// Scans for peripherals until len are found or the timeout expired
+		///
+		/// @param devices		Scanned devices
+		/// @param len			Maximum amount of devices
+		/// @param timeout		Time to scan [ms]
+		/// @return				amount of devices found
+		///
+		Task<uint8_t> AsyncScan(Bluetooth::BluetoothLEPeripheral* devices, uint8_t len, uint32_t timeout);
+
+		///
+		/// Connects to the peripheral and awaits the Connected status
+		///
+		/// @param peripheral	Peripheral to connect to
+		/// @param timeout		Maximum time to wait for the connection [ms]
+		/// @return				true if connected
+		///
+		Task<bool> AsyncConnect(const Bluetooth::BluetoothLEPeripheral& peripheral, uint32_t timeout);
+
+	private:
+		enum LineFilter
+		{
+			FILTER_STATUS,		// AOK or ERR
+			FILTER_VALUE,		// a value or ERR (no status, event or scan result)
+			FILTER_SCAN,		// a scan result
+			FILTER_CONNECTED,	// Connected
+			FILTER_CMD			// CMD
+		};
+
+		///
+		/// Awaits the next line matching the filter, lines which don't match are skipped
+		///
+		class LineAwaiter
+		{
+		public:
+			LineAwaiter(AsyncRN4020& module, LineFilter filter, char* buf, uint32_t len, uint32_t timeout);
+
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<> handle);
+
+			int32_t await_resume() const noexcept
+			{
+				return m_Received;
+			}
+
+		private:
+			friend class AsyncRN4020;
+
+			AsyncRN4020& m_Module;
+			LineFilter m_Filter;
+			char* m_Buffer;
+			uint32_t m_Length;
+			uint32_t m_Timeout;
+			int32_t m_Received;
+			EventLoop::TimerId m_Timer;
+			std::coroutine_handle<> m_Handle;
+
+			bool Offer(const char* line, int32_t len);
+			static void OnTimeout(void* context);
+		};
+
+		static const uint16_t LINE_LEN = 128;
+
+		EventLoop& m_Loop;
+		Serial::Linux::LinuxSerialPort& m_Port;
+		Serial::DelimiterSerial<uint16_t, 256, Bluetooth::Drivers::g_NewLineDelimiter> m_Lines;
+		std::deque<LineAwaiter*> m_Waiting;
+
+		// responses of commands which timed out, the module still sends them in order
+		std::deque<LineFilter> m_Late;
+		uint32_t m_ResponseTimeout;
+
+		LineAwaiter WaitLine(LineFilter filter, char* buf, uint32_t len, uint32_t timeout);
+
+		static void OnReadable(void* context);
+		static bool Matches(LineFilter filter, const char* line);
+	};
+}
+
+#endif // !ASYNC_RN4020_H_
@@ -0,0 +1,136 @@
+#include "EventLoop.h"
+
+// std libraries
+#include <algorithm>
+#include <cerrno>
+#include <poll.h>
+
+namespace Async
+{
+	EventLoop::EventLoop()
+		: m_NextTimerId(1)
+	{
+	}
+
+	void EventLoop::Watch(int fd, Callback callback, void* context)
+	{
+		Unwatch(fd);
+		m_Watchers.push_back({ fd, callback, context });
+	}
+
+	void EventLoop::Unwatch(int fd)
+	{
+		m_Watchers.erase(std::remove_if(m_Watchers.begin(), m_Watchers.end(), [fd](const Watcher& watcher)
+		{
+			return watcher.Fd == fd;
+		}), m_Watchers.end());
+	}
+
+	EventLoop::TimerId EventLoop::AddTimer(uint32_t timeout, Callback callback, void* context)
+	{
+		TimerId id = m_NextTimerId++;
+		m_Timers.push_back({ id, Clock::now() + std::chrono::milliseconds(timeout), callback, context });
+
+		return id;
+	}
+
+	void EventLoop::CancelTimer(TimerId id)
+	{
+		m_Timers.erase(std::remove_if(m_Timers.begin(), m_Timers.end(), [id](const Timer& timer)
+		{
+			return timer.Id == id;
+		}), m_Timers.end());
+	}
+
+	void EventLoop::Spawn(Task<void> task)
+	{
+		m_Tasks.push_back(std::move(task));
+		m_Tasks.back().Start();
+	}
+
+	bool EventLoop::RunOnce(int32_t timeout)
+	{
+		// don't sleep past the first timer
+		Clock::time_point now = Clock::now();
+		for (const Timer& timer : m_Timers)
+		{
+			int32_t remaining = static_cast<int32_t>(std::chrono::ceil<std::chrono::milliseconds>(timer.Due - now).count());
+			if (remaining < 0)
+				remaining = 0;
+
+			if (timeout == -1 || remaining < timeout)
+				timeout = remaining;
+		}
+
+		std::vector<pollfd> fds;
+		fds.reserve(m_Watchers.size());
+		for (const Watcher& watcher : m_Watchers)
+			fds.push_back({ watcher.Fd, POLLIN, 0 });
+
+		int ready = poll(fds.data(), fds.size(), timeout);
+		if (ready == -1 && errno != EINTR)
+			return false;
+
+		// the callbacks may (un)watch, so look the watcher up again
+		for (const pollfd& fd : fds)
+		{
+			if (ready <= 0 || !(fd.revents & (POLLIN | POLLHUP | POLLERR)))
+				continue;
+
+			for (const Watcher& watcher : m_Watchers)
+			{
+				if (watcher.Fd != fd.fd)
+					continue;
+
+				Watcher copy = watcher;
+				copy.Function(copy.Context);
+				break;
+			}
+		}
+
+		ExpireTimers();
+		return true;
+	}
+
+	bool EventLoop::Run()
+	{
+		while (!IsDone())
+		{
+			if (!RunOnce())
+				return false;
+		}
+
+		m_Tasks.clear();
+		return true;
+	}
+
+	bool EventLoop::IsDone() const
+	{
+		return std::all_of(m_Tasks.begin(), m_Tasks.end(), [](const Task<void>& task)
+		{
+			return task.IsDone();
+		});
+	}
+
+	void EventLoop::ExpireTimers()
+	{
+		Clock::time_point now = Clock::now();
+
+		// one at a time, a callback may add or cancel other timers
+		while (true)
+		{
+			auto it = std::find_if(m_Timers.begin(), m_Timers.end(), [now](const Timer& timer)
+			{
+				return timer.Due <= now;
+			});
+
+			if (it == m_Timers.end())
+				break;
+
+			Timer timer = *it;
+			m_Timers.erase(it);
+
+			timer.Function(timer.Context);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#ifndef ASYNC_EVENT_LOOP_H_
+#define ASYNC_EVENT_LOOP_H_
+
+// user libraries
+#include "Task.h"
+
+// std libraries
+#include <chrono>
+#include <inttypes.h>
+#include <vector>
+
+namespace Async
+{
+	///
+	/// Single threaded event loop which waits for file descriptors to become readable and for
+	/// timers to expire, and runs the spawned tasks until they are done. All callbacks and
+	/// coroutines run on the thread calling Run.
+	///
+	class EventLoop
+	{
+	public:
+		typedef void (*Callback)(void* context);
+		typedef uint32_t TimerId;
+
+		EventLoop();
+
+		///
+		/// Calls the callback whenever the file descriptor is readable
+		///
+		/// @param fd			File descriptor to watch
+		/// @param callback		Called when readable
+		/// @param context		Passed to the callback
+		///
+		void Watch(int fd, Callback callback, void* context);
+
+		///
+		/// Stops watching the file descriptor
+		///
+		/// @param fd			File descriptor to stop watching
+		///
+		void Unwatch(int fd);
+
+		///
+		/// Calls the callback once after the timeout
+		///
+		/// @param timeout		Timeout [ms]
+		/// @param callback		Called when expired
+		/// @param context		Passed to the callback
+		/// @return				id to cancel the timer with
+		///
+		TimerId AddTimer(uint32_t timeout, Callback callback, void* context);
+
+		///
+		/// Cancels a timer which hasn't expired yet
+		///
+		/// @param id			Id returned by AddTimer
+		///
+		void CancelTimer(TimerId id);
+
+		///
+		/// Starts the task, the loop owns it until Run returns
+		///
+		/// @param task			Task to run
+		///
+		void Spawn(Task<void> task);
+
+		///
+		/// Waits once for readable file descriptors or expired timers and handles them
+		///
+		/// @param timeout		Maximum time to wait [ms] (-1 waits until the next timer)
+		/// @return				false if waiting failed
+		///
+		bool RunOnce(int32_t timeout = -1);
+
+		///
+		/// Runs the loop until all spawned tasks are done
+		///
+		/// @return				false if waiting failed
+		///
+		bool Run();
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Watcher
+		{
+			int Fd;
+			Callback Function;
+			void* Context;
+		};
+
+		struct Timer
+		{
+			TimerId Id;
+			Clock::time_point Due;
+			Callback Function;
+			void* Context;
+		};
+
+		std::vector<Watcher> m_Watchers;
+		std::vector<Timer> m_Timers;
+		std::vector<Task<void>> m_Tasks;
+		TimerId m_NextTimerId;
+
+		bool IsDone() const;
+		void ExpireTimers();
+	};
+}
+
+#endif // !ASYNC_EVENT_LOOP_H_
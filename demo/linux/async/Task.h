@@ -0,0 +1,194 @@
+#ifndef ASYNC_TASK_H_
+#define ASYNC_TASK_H_
+
+// std libraries
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace Async
+{
+	template <typename T>
+	class Task;
+
+	namespace Detail
+	{
+		///
+		/// Resumes the awaiting coroutine when the task finished (symmetric transfer, so a
+		/// chain of tasks doesn't grow the stack)
+		///
+		struct FinalAwaiter
+		{
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			template <typename TPromise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) const noexcept
+			{
+				std::coroutine_handle<> continuation = handle.promise().m_Continuation;
+				return continuation ? continuation : std::noop_coroutine();
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		struct PromiseBase
+		{
+			std::coroutine_handle<> m_Continuation;
+
+			std::suspend_always initial_suspend() const noexcept
+			{
+				return {};
+			}
+
+			FinalAwaiter final_suspend() const noexcept
+			{
+				return {};
+			}
+
+			void unhandled_exception() const
+			{
+				std::terminate();
+			}
+		};
+
+		template <typename T>
+		struct Promise : PromiseBase
+		{
+			T m_Value{};
+
+			Task<T> get_return_object();
+
+			void return_value(T value)
+			{
+				m_Value = std::move(value);
+			}
+
+			T Result()
+			{
+				return std::move(m_Value);
+			}
+		};
+
+		template <>
+		struct Promise<void> : PromiseBase
+		{
+			Task<void> get_return_object();
+
+			void return_void() const
+			{
+			}
+
+			void Result() const
+			{
+			}
+		};
+	}
+
+	///
+	/// Lazily started coroutine which produces a T. It starts when it is awaited (or spawned on
+	/// the EventLoop) and resumes the awaiting coroutine when it returns.
+	///
+	/// @tparam T		Type of the result
+	///
+	template <typename T>
+	class Task
+	{
+	public:
+		typedef Detail::Promise<T> promise_type;
+		typedef std::coroutine_handle<promise_type> Handle;
+
+		explicit Task(Handle handle)
+			: m_Handle(handle)
+		{
+		}
+
+		Task(Task&& other) noexcept
+			: m_Handle(std::exchange(other.m_Handle, nullptr))
+		{
+		}
+
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				if (m_Handle)
+					m_Handle.destroy();
+
+				m_Handle = std::exchange(other.m_Handle, nullptr);
+			}
+
+			return *this;
+		}
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		~Task()
+		{
+			if (m_Handle)
+				m_Handle.destroy();
+		}
+
+		///
+		/// Starts the task without awaiting it, it runs until its first suspension point
+		///
+		void Start() const
+		{
+			if (m_Handle && !m_Handle.done())
+				m_Handle.resume();
+		}
+
+		bool IsDone() const
+		{
+			return !m_Handle || m_Handle.done();
+		}
+
+		///
+		/// Gets the result of a finished task
+		///
+		T GetResult() const
+		{
+			return m_Handle.promise().Result();
+		}
+
+		bool await_ready() const noexcept
+		{
+			return IsDone();
+		}
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept
+		{
+			m_Handle.promise().m_Continuation = awaiting;
+			return m_Handle;
+		}
+
+		T await_resume() const
+		{
+			return m_Handle.promise().Result();
+		}
+
+	private:
+		Handle m_Handle;
+	};
+
+	namespace Detail
+	{
+		template <typename T>
+		Task<T> Promise<T>::get_return_object()
+		{
+			return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+		}
+
+		inline Task<void> Promise<void>::get_return_object()
+		{
+			return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+		}
+	}
+}
+
+#endif // !ASYNC_TASK_H_
@@ -0,0 +1,67 @@
+// user libraries
+#include "AsyncRN4020.h"
+
+// std libraries
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace Async;
+using namespace Bluetooth;
+
+namespace
+{
+	const uint8_t MAX_DEVICES = 8;
+
+	Task<void> run(AsyncRN4020& module, const char* device)
+	{
+		char name[21];
+		if (!co_await module.AsyncGetName(name, sizeof(name)))
+		{
+			cerr << device << ": no response" << endl;
+			co_return;
+		}
+
+		cout << device << ": " << name << endl;
+
+		BluetoothLEPeripheral peripherals[MAX_DEVICES];
+		uint8_t found = co_await module.AsyncScan(peripherals, MAX_DEVICES, 2000);
+
+		char mac[18];
+		for (uint8_t i = 0; i < found; ++i)
+		{
+			peripherals[i].GetMACAddress().ToCharArray(mac, sizeof(mac));
+			cout << device << ": found " << mac << " " << peripherals[i].GetName() << endl;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		cerr << "Usage: " << argv[0] << " <device> [device ...]" << endl;
+		return 1;
+	}
+
+	EventLoop loop;
+	vector<unique_ptr<Serial::Linux::LinuxSerialPort>> ports;
+	vector<unique_ptr<AsyncRN4020>> modules;
+
+	// all modules are handled concurrently on this thread
+	for (int i = 1; i < argc; ++i)
+	{
+		ports.emplace_back(new Serial::Linux::LinuxSerialPort(argv[i], Serial::BAUDRATE_115200, Serial::DATABIT_8, Serial::PARITYBIT_NONE, Serial::STOPBIT_1));
+		if (!ports.back()->Open())
+		{
+			cerr << "Failed to open " << argv[i] << endl;
+			return 1;
+		}
+
+		modules.emplace_back(new AsyncRN4020(loop, *ports.back()));
+		loop.Spawn(run(*modules.back(), argv[i]));
+	}
+
+	return loop.Run() ? 0 : 1;
+}
@@ -0,0 +1,576 @@
+#include "RN4020Emulator.h"
+
+// std libraries
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+// RN4020Emulator Constants
+#define EMULATOR_MAC "001EC0A1B2C3"
+#define EMULATOR_FIRMWARE "MCHP BTLE v1.33.4 (emulated)"
+#define REBOOT_TIME_MS 500
+
+namespace
+{
+	std::vector<std::string> split(const std::string& line)
+	{
+		std::vector<std::string> tokens;
+
+		size_t start = 0;
+		size_t end;
+		while ((end = line.find(',', start)) != std::string::npos)
+		{
+			tokens.push_back(line.substr(start, end - start));
+			start = end + 1;
+		}
+
+		tokens.push_back(line.substr(start));
+		return tokens;
+	}
+
+	uint16_t parseHex16(const std::string& hex)
+	{
+		return static_cast<uint16_t>(strtoul(hex.c_str(), NULL, 16));
+	}
+
+	std::string formatHex16(uint16_t value)
+	{
+		char buf[5];
+		snprintf(buf, sizeof(buf), "%04X", value);
+		return buf;
+	}
+
+	bool isHex(const std::string& value)
+	{
+		return !value.empty() && value.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+	}
+}
+
+namespace Emulator
+{
+	RN4020Emulator::RN4020Emulator()
+		: m_Fd(-1),
+		  m_SlaveFd(-1),
+		  m_ByteTime(10000000 / 115200),
+		  m_ResponseDelay(std::chrono::milliseconds(1)),
+		  m_ConnectDelay(std::chrono::milliseconds(50)),
+		  m_AdvertisementInterval(std::chrono::milliseconds(100)),
+		  m_IsScanning(false),
+		  m_ScanIndex(0),
+		  m_Connecting(NULL),
+		  m_Connected(NULL)
+	{
+		// factory defaults
+		m_Settings["SB"] = "4";
+		m_Settings["SR"] = "00000000";
+		m_Settings["SS"] = "00000000";
+		m_Settings["SN"] = "RN4020_EMU";
+		m_Settings["SP"] = "4";
+		m_Settings["ST"] = "0006,0000,0064";
+		m_Settings["SDF"] = "1.33.4";
+		m_Settings["SDH"] = "1.0";
+		m_Settings["SDM"] = "RN4020";
+		m_Settings["SDN"] = "Microchip";
+		m_Settings["SDR"] = "1.33.4";
+		m_Settings["SDS"] = "0001";
+	}
+
+	RN4020Emulator::~RN4020Emulator()
+	{
+		Close();
+	}
+
+	bool RN4020Emulator::Open()
+	{
+		m_Fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+		if (m_Fd == -1)
+			return false;
+
+		if (grantpt(m_Fd) != 0 || unlockpt(m_Fd) != 0)
+		{
+			Close();
+			return false;
+		}
+
+		m_DeviceName = ptsname(m_Fd);
+
+		// keep the slave side open ourselves, otherwise the master hangs up every time the
+		// driver closes its port
+		m_SlaveFd = open(m_DeviceName.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+		if (m_SlaveFd == -1)
+		{
+			Close();
+			return false;
+		}
+
+		termios tty;
+		if (tcgetattr(m_SlaveFd, &tty) != 0)
+		{
+			Close();
+			return false;
+		}
+
+		cfmakeraw(&tty);
+		if (tcsetattr(m_SlaveFd, TCSANOW, &tty) != 0)
+		{
+			Close();
+			return false;
+		}
+
+		Queue("CMD");
+		return true;
+	}
+
+	void RN4020Emulator::Close()
+	{
+		if (m_SlaveFd != -1)
+		{
+			close(m_SlaveFd);
+			m_SlaveFd = -1;
+		}
+
+		if (m_Fd != -1)
+		{
+			close(m_Fd);
+			m_Fd = -1;
+		}
+	}
+
+	bool RN4020Emulator::Poll(int32_t timeout)
+	{
+		if (m_Fd == -1)
+			return false;
+
+		// don't sleep past the next line we have to output
+		Clock::time_point now = Clock::now();
+		Clock::time_point next = Clock::time_point::max();
+		if (!m_Pending.empty())
+			next = m_Pending.front().Due;
+		if (m_IsScanning && !m_Peripherals.empty())
+			next = std::min(next, m_NextScan);
+
+		if (next != Clock::time_point::max())
+		{
+			int64_t until = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+			if (until < 0)
+				until = 0;
+			if (timeout < 0 || until < timeout)
+				timeout = static_cast<int32_t>(until);
+		}
+
+		pollfd fd = { m_Fd, POLLIN, 0 };
+		int ready = poll(&fd, 1, timeout);
+		if (ready == -1 && errno != EINTR)
+			return false;
+
+		if (ready > 0 && (fd.revents & POLLIN))
+		{
+			char buf[256];
+			ssize_t received = read(m_Fd, buf, sizeof(buf));
+			if (received == -1 && errno != EAGAIN && errno != EINTR)
+				return false;
+
+			if (received > 0)
+				m_Input.append(buf, received);
+
+			// the module accepts both \r and \n as end of command
+			size_t end;
+			while ((end = m_Input.find_first_of("\r\n")) != std::string::npos)
+			{
+				std::string line = m_Input.substr(0, end);
+				m_Input.erase(0, end + 1);
+
+				if (!line.empty())
+					Execute(line);
+			}
+		}
+
+		ProcessTimers();
+		return true;
+	}
+
+	void RN4020Emulator::AddPeripheral(const char* mac, bool isRandom, const char* name, const char* primaryService, int8_t rssi)
+	{
+		Peripheral peripheral = { mac, isRandom, name, primaryService, rssi };
+		m_Peripherals.push_back(peripheral);
+	}
+
+	void RN4020Emulator::AddClientService(const char* uuid)
+	{
+		Service service;
+		service.Uuid = uuid;
+
+		m_ClientServices.push_back(service);
+	}
+
+	void RN4020Emulator::AddClientCharacteristic(const char* uuid, uint16_t handle, uint8_t property, const char* value)
+	{
+		if (m_ClientServices.empty())
+			return;
+
+		char buf[3];
+		snprintf(buf, sizeof(buf), "%02X", property);
+
+		Characteristic characteristic = { uuid, handle, buf };
+		m_ClientServices.back().Characteristics.push_back(characteristic);
+		m_ClientValues[handle] = value;
+	}
+
+	void RN4020Emulator::Inject(const char* line)
+	{
+		Queue(line);
+	}
+
+	void RN4020Emulator::Execute(const std::string& line)
+	{
+		std::vector<std::string> tokens = split(line);
+		const std::string& command = tokens[0];
+		size_t params = tokens.size() - 1;
+
+		// settings which are simply stored and can be requested by the matching G command
+		if (command == "SB" || command == "SR" || command == "SS" || command == "SN" || command == "SP" ||
+			command == "S-" || command == "SDF" || command == "SDH" || command == "SDM" || command == "SDN" ||
+			command == "SDR" || command == "SDS" || command == "ST")
+		{
+			if (params == 0)
+				return Respond("ERR");
+
+			m_Settings[command] = line.substr(command.size() + 1);
+			if (command == "SS")
+				UpdateServerServices();
+
+			return Respond("AOK");
+		}
+
+		if (command.size() >= 2 && command[0] == 'G' && m_Settings.count("S" + command.substr(1)))
+			return Respond(m_Settings["S" + command.substr(1)]);
+
+		if (command == "SF")
+			return Respond(params == 1 && (tokens[1] == "1" || tokens[1] == "2") ? "AOK" : "ERR");
+
+		if (command == "A" || command == "J" || command == "U" || command == "Y" || command == "N")
+			return Respond("AOK");
+
+		if (command == "B" || command == "T")
+			return Respond(m_Connected ? "AOK" : "ERR");
+
+		if (command == "F")
+		{
+			m_IsScanning = true;
+			m_ScanIndex = 0;
+			m_NextScan = Clock::now() + m_ResponseDelay + m_AdvertisementInterval / 2;
+			return Respond("AOK");
+		}
+
+		if (command == "X")
+		{
+			m_IsScanning = false;
+			return Respond("AOK");
+		}
+
+		if (command == "E")
+		{
+			if (params != 2 || m_Connected)
+				return Respond("ERR");
+
+			Respond("AOK");
+			for (size_t i = 0; i < m_Peripherals.size(); ++i)
+			{
+				if (m_Peripherals[i].Mac != tokens[2])
+					continue;
+
+				m_Connecting = &m_Peripherals[i];
+				Queue("Connected", m_ResponseDelay + m_ConnectDelay);
+			}
+
+			return;
+		}
+
+		if (command == "Z")
+		{
+			if (m_Connecting && !m_Connected)
+			{
+				m_Connecting = NULL;
+				m_Pending.erase(std::remove_if(m_Pending.begin(), m_Pending.end(), [](const PendingLine& pending)
+				{
+					return pending.Line == "Connected";
+				}), m_Pending.end());
+			}
+
+			return Respond("AOK");
+		}
+
+		if (command == "K")
+		{
+			if (!m_Connected)
+				return Respond("ERR");
+
+			Respond("AOK");
+			Disconnect();
+			return;
+		}
+
+		if (command == "M")
+		{
+			if (!m_Connected)
+				return Respond("No Connection");
+
+			char buf[8];
+			snprintf(buf, sizeof(buf), "%s%X", m_Connected->Rssi < 0 ? "-" : "", abs(m_Connected->Rssi));
+			return Respond(buf);
+		}
+
+		if (command == "D")
+			return Dump();
+
+		if (command == "V")
+			return Respond(EMULATOR_FIRMWARE);
+
+		if (command == "O")
+			return;
+
+		if (command == "R")
+		{
+			if (params != 1 || tokens[1] != "1")
+				return Respond("ERR");
+
+			m_IsScanning = false;
+			m_Connecting = NULL;
+			m_Connected = NULL;
+			m_Pending.clear();
+
+			Respond("Reboot");
+			Queue("CMD", m_ResponseDelay + std::chrono::milliseconds(REBOOT_TIME_MS));
+			return;
+		}
+
+		if (command == "LS")
+			return List(m_ServerServices);
+
+		if (command == "LC")
+		{
+			if (!m_Connected)
+				return Respond("ERR");
+
+			return List(m_ClientServices);
+		}
+
+		// server characteristics
+		if (command == "SHW" && params == 2)
+			return WriteValue(m_ServerValues, parseHex16(tokens[1]), tokens[2]);
+		if (command == "SUW" && params == 2)
+			return WriteValue(m_ServerValues, FindHandle(m_ServerServices, tokens[1]), tokens[2]);
+		if (command == "SHR" && params == 1)
+			return ReadValue(m_ServerValues, parseHex16(tokens[1]), false);
+		if (command == "SUR" && params == 1)
+			return ReadValue(m_ServerValues, FindHandle(m_ServerServices, tokens[1]), false);
+
+		// client characteristics (only when connected)
+		if (command[0] == 'C' && !m_Connected)
+			return Respond("ERR");
+
+		if (command == "CHW" && params == 2)
+			return WriteValue(m_ClientValues, parseHex16(tokens[1]), tokens[2]);
+		if (command == "CUWV" && params == 2)
+			return WriteValue(m_ClientValues, FindHandle(m_ClientServices, tokens[1]), tokens[2]);
+		if (command == "CUWC" && params == 2)
+			return Respond(FindHandle(m_ClientServices, tokens[1]) ? "AOK" : "ERR");
+		if (command == "CHR" && params == 1)
+			return ReadValue(m_ClientValues, parseHex16(tokens[1]), true);
+		if (command == "CURV" && params == 1)
+			return ReadValue(m_ClientValues, FindHandle(m_ClientServices, tokens[1]), true);
+
+		Respond("ERR");
+	}
+
+	void RN4020Emulator::Queue(const std::string& line, Clock::duration delay)
+	{
+		PendingLine pending = { Clock::now() + delay, line };
+
+		// keep the output in order of due time, equal times in order of queueing
+		std::vector<PendingLine>::iterator it = std::upper_bound(m_Pending.begin(), m_Pending.end(), pending,
+			[](const PendingLine& a_Lhs, const PendingLine& a_Rhs)
+		{
+			return a_Lhs.Due < a_Rhs.Due;
+		});
+
+		m_Pending.insert(it, pending);
+	}
+
+	void RN4020Emulator::Respond(const std::string& line)
+	{
+		Queue(line, m_ResponseDelay);
+	}
+
+	bool RN4020Emulator::Write(const std::string& line)
+	{
+		std::string data = line + "\r\n";
+
+		// pace the bytes as the UART would
+		Clock::time_point next = Clock::now();
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			if (m_ByteTime)
+			{
+				next += std::chrono::microseconds(m_ByteTime);
+				std::this_thread::sleep_until(next);
+			}
+
+			ssize_t written;
+			do
+			{
+				written = write(m_Fd, &data[i], 1);
+			} while (written == -1 && (errno == EINTR || errno == EAGAIN));
+
+			if (written != 1)
+				return false;
+		}
+
+		return true;
+	}
+
+	void RN4020Emulator::ProcessTimers()
+	{
+		while (!m_Pending.empty() && m_Pending.front().Due <= Clock::now())
+		{
+			std::string line = m_Pending.front().Line;
+			m_Pending.erase(m_Pending.begin());
+
+			if (line == "Connected" && m_Connecting)
+			{
+				m_Connected = m_Connecting;
+				m_Connecting = NULL;
+			}
+
+			Write(line);
+		}
+
+		if (!m_IsScanning || m_Peripherals.empty() || Clock::now() < m_NextScan)
+			return;
+
+		// every peripheral advertises once per interval
+		Write(ScanLine(m_Peripherals[m_ScanIndex]));
+		m_ScanIndex = (m_ScanIndex + 1) % m_Peripherals.size();
+		m_NextScan += m_AdvertisementInterval / m_Peripherals.size();
+	}
+
+	void RN4020Emulator::List(const std::vector<Service>& services)
+	{
+		for (size_t i = 0; i < services.size(); ++i)
+		{
+			Respond(services[i].Uuid);
+
+			const std::vector<Characteristic>& characteristics = services[i].Characteristics;
+			for (size_t j = 0; j < characteristics.size(); ++j)
+			{
+				const Characteristic& characteristic = characteristics[j];
+				Respond("  " + characteristic.Uuid + "," + formatHex16(characteristic.Handle) + "," + characteristic.Property);
+			}
+		}
+
+		Respond("END");
+	}
+
+	void RN4020Emulator::ReadValue(const std::map<uint16_t, std::string>& values, uint16_t handle, bool isClient)
+	{
+		std::map<uint16_t, std::string>::const_iterator it = values.find(handle);
+		std::string value = it == values.end() ? "00" : it->second;
+
+		if (handle == 0)
+			return Respond("ERR");
+
+		Respond(isClient ? "R," + value + "." : value);
+	}
+
+	void RN4020Emulator::WriteValue(std::map<uint16_t, std::string>& values, uint16_t handle, const std::string& value)
+	{
+		if (handle == 0 || !isHex(value) || value.size() % 2 != 0 || value.size() > 40)
+			return Respond("ERR");
+
+		values[handle] = value;
+		Respond("AOK");
+	}
+
+	void RN4020Emulator::Dump()
+	{
+		Respond("BTA=" EMULATOR_MAC);
+		Respond("Name=" + m_Settings["SN"]);
+		Respond("Connected=" + (m_Connected ? m_Connected->Mac + "," + (m_Connected->IsRandom ? "1" : "0") : std::string("no")));
+		Respond("Bonded=no");
+		Respond("Server Service=" + m_Settings["SS"]);
+		Respond("Features=" + m_Settings["SR"]);
+		Respond("TxPower=" + m_Settings["SP"]);
+	}
+
+	void RN4020Emulator::Disconnect()
+	{
+		m_Connected = NULL;
+		Queue("Connection End", m_ResponseDelay);
+	}
+
+	uint16_t RN4020Emulator::FindHandle(const std::vector<Service>& services, const std::string& uuid) const
+	{
+		for (size_t i = 0; i < services.size(); ++i)
+		{
+			const std::vector<Characteristic>& characteristics = services[i].Characteristics;
+			for (size_t j = 0; j < characteristics.size(); ++j)
+			{
+				// the value handle, not the configuration
+				if (characteristics[j].Uuid == uuid && characteristics[j].Property != "C")
+					return characteristics[j].Handle;
+			}
+		}
+
+		return 0;
+	}
+
+	std::string RN4020Emulator::ScanLine(const Peripheral& peripheral) const
+	{
+		char rssi[8];
+		snprintf(rssi, sizeof(rssi), "%s%X", peripheral.Rssi < 0 ? "-" : "", abs(peripheral.Rssi));
+
+		return peripheral.Mac + "," + (peripheral.IsRandom ? "1" : "0") + "," + peripheral.Name + "," +
+			peripheral.PrimaryService + "," + rssi;
+	}
+
+	void RN4020Emulator::UpdateServerServices()
+	{
+		uint32_t services = strtoul(m_Settings["SS"].c_str(), NULL, 16);
+		m_ServerServices.clear();
+
+		// only the services used by the demos have their characteristics modelled
+		if (services & 0x80000000)
+		{
+			Service service;
+			service.Uuid = "180A";
+
+			const char* uuids[] = { "2A25", "2A27", "2A26", "2A28", "2A29", "2A24" };
+			for (uint16_t i = 0; i < 6; ++i)
+			{
+				Characteristic characteristic = { uuids[i], static_cast<uint16_t>(0x000E + i * 2), "V" };
+				service.Characteristics.push_back(characteristic);
+			}
+
+			m_ServerServices.push_back(service);
+		}
+
+		if (services & 0x40000000)
+		{
+			Service service;
+			service.Uuid = "180F";
+
+			Characteristic value = { "2A19", 0x001B, "V" };
+			Characteristic configuration = { "2A19", 0x001C, "C" };
+			service.Characteristics.push_back(value);
+			service.Characteristics.push_back(configuration);
+
+			m_ServerServices.push_back(service);
+		}
+	}
+}
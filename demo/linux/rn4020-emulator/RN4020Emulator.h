@@ -0,0 +1,229 @@
+#ifndef RN4020_EMULATOR_H_
+#define RN4020_EMULATOR_H_
+
+// std libraries
+#include <chrono>
+#include <inttypes.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Emulator
+{
+	///
+	/// Software model of a RN4020 module in command mode. It opens the master side of a
+	/// pseudo-terminal and answers the ASCII commands on it, the slave side (see GetDeviceName)
+	/// can be opened as a serial port by the driver. \n
+	/// All output is paced per byte as it would be on a real UART, so it can be used to measure
+	/// the latency and throughput of the driver without hardware.
+	///
+	class RN4020Emulator
+	{
+	public:
+		///
+		/// Constructs an emulator which isn't opened yet, with 115200 baud UART timing
+		///
+		RN4020Emulator();
+		~RN4020Emulator();
+
+		///
+		/// Opens the pseudo-terminal and outputs CMD as the module does after power on
+		///
+		/// @return	true if operation completed succesfully
+		///
+		bool Open();
+
+		///
+		/// Closes the pseudo-terminal
+		///
+		void Close();
+
+		///
+		/// Gets the path of the slave side of the pseudo-terminal (e.g. /dev/pts/3)
+		///
+		/// @return				path of the device to open by the driver
+		///
+		const char* GetDeviceName() const
+		{
+			return m_DeviceName.c_str();
+		}
+
+		///
+		/// Gets the file descriptor of the master side
+		///
+		/// @return				the file descriptor, -1 if not opened
+		///
+		int GetFileDescriptor() const
+		{
+			return m_Fd;
+		}
+
+		///
+		/// Processes received commands and pending output (scan results, connection events),
+		/// waiting up to timeout for input.
+		///
+		/// @param timeout		Maximum time to wait for input [ms]
+		/// @return				false if the pseudo-terminal failed
+		///
+		bool Poll(int32_t timeout);
+
+		///
+		/// Sets the time it takes to transmit a single byte over the UART
+		///
+		/// @param microseconds		Time per byte [us], 0 disables the pacing
+		///
+		void SetByteTime(uint32_t microseconds)
+		{
+			m_ByteTime = microseconds;
+		}
+
+		///
+		/// Sets the byte time from a baud rate (8N1: 10 bits per byte)
+		///
+		/// @param baudrate		Baud rate to emulate, 0 is ignored
+		///
+		void SetBaudRate(uint32_t baudrate)
+		{
+			if (baudrate > 0)
+				m_ByteTime = 10000000 / baudrate;
+		}
+
+		///
+		/// Sets the processing time of the module before it starts answering a command
+		///
+		/// @param milliseconds		Delay before the response [ms]
+		///
+		void SetResponseDelay(uint32_t milliseconds)
+		{
+			m_ResponseDelay = std::chrono::milliseconds(milliseconds);
+		}
+
+		///
+		/// Sets the time between the E command and the Connected status
+		///
+		/// @param milliseconds		Delay before connected [ms]
+		///
+		void SetConnectDelay(uint32_t milliseconds)
+		{
+			m_ConnectDelay = std::chrono::milliseconds(milliseconds);
+		}
+
+		///
+		/// Sets the time between two scan results of the same peripheral while scanning
+		///
+		/// @param milliseconds		Advertisement interval [ms]
+		///
+		void SetAdvertisementInterval(uint32_t milliseconds)
+		{
+			m_AdvertisementInterval = std::chrono::milliseconds(milliseconds);
+		}
+
+		///
+		/// Adds a peripheral which is reported while scanning and which can be connected to
+		///
+		/// @param mac				12 char hex MAC Address
+		/// @param isRandom			Specifies if the MAC Address is random
+		/// @param name				Advertised name (may be empty)
+		/// @param primaryService	Primary service as hex (may be empty)
+		/// @param rssi				RSSI reported in the scan results
+		///
+		void AddPeripheral(const char* mac, bool isRandom, const char* name, const char* primaryService, int8_t rssi);
+
+		///
+		/// Adds a service to the GATT server of the connected peer (listed by LC)
+		///
+		/// @param uuid			Service UUID as hex (4 or 32 chars)
+		///
+		void AddClientService(const char* uuid);
+
+		///
+		/// Adds a characteristic to the last added client service
+		///
+		/// @param uuid			Characteristic UUID as hex (4 or 32 chars)
+		/// @param handle		Handle of the characteristic
+		/// @param property		Property bitmap (CharacteristicProperty)
+		/// @param value		Initial value as hex
+		///
+		void AddClientCharacteristic(const char* uuid, uint16_t handle, uint8_t property, const char* value);
+
+		///
+		/// Queues an unsolicited line (e.g. WV,001B,01.) which is sent as soon as possible
+		///
+		/// @param line			Line to output without the \r\n
+		///
+		void Inject(const char* line);
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Peripheral
+		{
+			std::string Mac;
+			bool IsRandom;
+			std::string Name;
+			std::string PrimaryService;
+			int8_t Rssi;
+		};
+
+		struct Characteristic
+		{
+			std::string Uuid;
+			uint16_t Handle;
+			std::string Property;
+		};
+
+		struct Service
+		{
+			std::string Uuid;
+			std::vector<Characteristic> Characteristics;
+		};
+
+		struct PendingLine
+		{
+			Clock::time_point Due;
+			std::string Line;
+		};
+
+		int m_Fd;
+		int m_SlaveFd;
+		std::string m_DeviceName;
+		std::string m_Input;
+
+		uint32_t m_ByteTime;
+		Clock::duration m_ResponseDelay;
+		Clock::duration m_ConnectDelay;
+		Clock::duration m_AdvertisementInterval;
+
+		std::map<std::string, std::string> m_Settings;
+		std::vector<Peripheral> m_Peripherals;
+		std::vector<Service> m_ServerServices;
+		std::vector<Service> m_ClientServices;
+		std::map<uint16_t, std::string> m_ServerValues;
+		std::map<uint16_t, std::string> m_ClientValues;
+		std::vector<PendingLine> m_Pending;
+
+		bool m_IsScanning;
+		size_t m_ScanIndex;
+		Clock::time_point m_NextScan;
+		const Peripheral* m_Connecting;
+		const Peripheral* m_Connected;
+
+		void Execute(const std::string& line);
+		void Queue(const std::string& line, Clock::duration delay = Clock::duration::zero());
+		void Respond(const std::string& line);
+		bool Write(const std::string& line);
+		void ProcessTimers();
+
+		void List(const std::vector<Service>& services);
+		void ReadValue(const std::map<uint16_t, std::string>& values, uint16_t handle, bool isClient);
+		void WriteValue(std::map<uint16_t, std::string>& values, uint16_t handle, const std::string& value);
+		void Dump();
+		void Disconnect();
+
+		uint16_t FindHandle(const std::vector<Service>& services, const std::string& uuid) const;
+		std::string ScanLine(const Peripheral& peripheral) const;
+		void UpdateServerServices();
+	};
+}
+
+#endif // !RN4020_EMULATOR_H_
@@ -0,0 +1,65 @@
+// user libraries
+#include "RN4020Emulator.h"
+
+// std libraries
+#include <cstdlib>
+#include <iostream>
+#include <poll.h>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+using namespace Emulator;
+
+int main(int argc, char* argv[])
+{
+	uint32_t baudrate = 115200;
+	if (argc > 1)
+	{
+		char* end;
+		baudrate = strtoul(argv[1], &end, 10);
+		if (baudrate == 0 || *end != '\0')
+		{
+			cerr << "Usage: " << argv[0] << " [baudrate]" << endl;
+			return 1;
+		}
+	}
+
+	RN4020Emulator emulator;
+	emulator.SetBaudRate(baudrate);
+
+	// the peripherals the demos look for
+	emulator.AddPeripheral("001EC01A2B3C", false, "MyClient", "180F", -0x40);
+	emulator.AddPeripheral("D4F513A0B1C2", true, "", "", -0x5A);
+	emulator.AddPeripheral("001EC0FFEE01", false, "MyServer", "180A", -0x48);
+
+	emulator.AddClientService("180F");
+	emulator.AddClientCharacteristic("2A19", 0x001A, 0x12, "64");
+	emulator.AddClientService("180A");
+	emulator.AddClientCharacteristic("2A29", 0x0010, 0x02, "4D434850");
+
+	if (!emulator.Open())
+	{
+		cerr << "Failed to open pseudo-terminal" << endl;
+		return 1;
+	}
+
+	cout << "Emulating RN4020 at " << baudrate << " baud on " << emulator.GetDeviceName() << endl;
+	cout << "Lines typed on stdin are sent as unsolicited output (e.g. WV,001B,01.)" << endl;
+
+	string input;
+	while (true)
+	{
+		if (!emulator.Poll(10))
+			return 1;
+
+		pollfd fd = { STDIN_FILENO, POLLIN, 0 };
+		if (poll(&fd, 1, 0) > 0)
+		{
+			if (!getline(cin, input))
+				return 0;
+
+			emulator.Inject(input.c_str());
+		}
+	}
+}
@@ -0,0 +1,276 @@
+#include "LinuxSerialPort.h"
+
+// std libraries
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace
+{
+	speed_t toSpeed(Serial::BaudRate baudrate)
+	{
+		switch (baudrate)
+		{
+		case Serial::BAUDRATE_300: return B300;
+		case Serial::BAUDRATE_600: return B600;
+		case Serial::BAUDRATE_1200: return B1200;
+		case Serial::BAUDRATE_1800: return B1800;
+		case Serial::BAUDRATE_2400: return B2400;
+		case Serial::BAUDRATE_4800: return B4800;
+		case Serial::BAUDRATE_9600: return B9600;
+		case Serial::BAUDRATE_19200: return B19200;
+		case Serial::BAUDRATE_38400: return B38400;
+		case Serial::BAUDRATE_57600: return B57600;
+		case Serial::BAUDRATE_115200: return B115200;
+		case Serial::BAUDRATE_230400: return B230400;
+		case Serial::BAUDRATE_460800: return B460800;
+		case Serial::BAUDRATE_921600: return B921600;
+		default: return B0; // 7200 and 14400 have no termios equivalent
+		}
+	}
+
+	tcflag_t toCharacterSize(Serial::DataBit databits)
+	{
+		switch (databits)
+		{
+		case Serial::DATABIT_5: return CS5;
+		case Serial::DATABIT_6: return CS6;
+		case Serial::DATABIT_7: return CS7;
+		default: return CS8;
+		}
+	}
+}
+
+namespace Serial
+{
+	namespace Linux
+	{
+		LinuxSerialPort::LinuxSerialPort(const char* device, BaudRate baudrate, DataBit databits, ParityBit parity, StopBit stopbits)
+			: IUartDriver(baudrate, databits, parity, stopbits),
+			  m_Device(device),
+			  m_Fd(-1),
+			  m_ReceiveTimeout(100),
+			  m_SendTimeout(1000),
+			  m_FlowControl(false)
+		{
+		}
+
+		LinuxSerialPort::~LinuxSerialPort()
+		{
+			Close();
+		}
+
+		bool LinuxSerialPort::Open()
+		{
+			speed_t speed = toSpeed(GetBaudrate());
+			if (speed == B0 || GetStopbits() == STOPBIT_15)
+				return false;
+
+			m_Fd = open(GetDevice(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+			if (m_Fd == -1)
+				return false;
+
+			termios tty;
+			if (tcgetattr(m_Fd, &tty) != 0)
+			{
+				Close();
+				return false;
+			}
+
+			// raw mode: no echo, no line editing, no translation of \r\n
+			cfmakeraw(&tty);
+			cfsetispeed(&tty, speed);
+			cfsetospeed(&tty, speed);
+
+			tty.c_cflag |= CLOCAL | CREAD;
+			tty.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB | CRTSCTS);
+			tty.c_cflag |= toCharacterSize(GetDatabits());
+
+			if (GetParity() != PARITYBIT_NONE)
+				tty.c_cflag |= PARENB;
+			if (GetParity() == PARITYBIT_ODD)
+				tty.c_cflag |= PARODD;
+			if (GetStopbits() == STOPBIT_2)
+				tty.c_cflag |= CSTOPB;
+			if (m_FlowControl)
+				tty.c_cflag |= CRTSCTS;
+
+			// the fd is non-blocking, so VMIN and VTIME have no effect: reads return what is
+			// available and Read waits with poll instead
+			tty.c_cc[VMIN] = 0;
+			tty.c_cc[VTIME] = 0;
+
+			if (tcsetattr(m_Fd, TCSANOW, &tty) != 0)
+			{
+				Close();
+				return false;
+			}
+
+			tcflush(m_Fd, TCIOFLUSH);
+			return true;
+		}
+
+		bool LinuxSerialPort::Close()
+		{
+			if (m_Fd != -1)
+			{
+				if (close(m_Fd) != 0)
+					return false;
+
+				m_Fd = -1;
+			}
+
+			return true;
+		}
+
+		int32_t LinuxSerialPort::Send(const char* buffer, uint32_t len) const
+		{
+			if (m_Fd == -1)
+				return -1;
+
+			uint32_t sent = 0;
+			while (sent < len)
+			{
+				ssize_t written = write(m_Fd, buffer + sent, len - sent);
+				if (written > 0)
+				{
+					sent += written;
+					continue;
+				}
+
+				if (written == -1 && errno == EINTR)
+					continue;
+
+				// output buffer is full, wait until the port drained some of it
+				if (written == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+				{
+					if (!WaitFor(POLLOUT, m_SendTimeout))
+						break;
+
+					continue;
+				}
+
+				return -1;
+			}
+
+			return sent;
+		}
+
+		int32_t LinuxSerialPort::SendVector(const SerialBuffer* buffers, uint8_t count) const
+		{
+			if (m_Fd == -1)
+				return -1;
+
+			iovec vectors[UINT8_MAX];
+			uint32_t len = 0;
+			for (uint8_t i = 0; i < count; ++i)
+			{
+				vectors[i].iov_base = const_cast<char*>(buffers[i].Data);
+				vectors[i].iov_len = buffers[i].Length;
+				len += buffers[i].Length;
+			}
+
+			ssize_t written;
+			do
+			{
+				written = writev(m_Fd, vectors, count);
+			} while (written == -1 && errno == EINTR);
+
+			if (written == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+				return -1;
+
+			if (written == -1)
+				written = 0;
+
+			if (static_cast<uint32_t>(written) == len)
+				return len;
+
+			// partially written, send the remainder of each buffer (waiting for the port to drain)
+			uint32_t sent = written;
+			for (uint8_t i = 0; i < count; ++i)
+			{
+				if (static_cast<uint32_t>(written) >= buffers[i].Length)
+				{
+					written -= buffers[i].Length;
+					continue;
+				}
+
+				int32_t tmp = Send(buffers[i].Data + written, buffers[i].Length - written);
+				if (tmp == -1)
+					return -1;
+
+				sent += tmp;
+				written = 0;
+			}
+
+			return sent;
+		}
+
+		int32_t LinuxSerialPort::Receive(char* buffer, uint32_t len) const
+		{
+			return Read(buffer, len, NULL);
+		}
+
+		int32_t LinuxSerialPort::ReceiveUntil(char* buffer, uint32_t len, const Util::Deadline& deadline) const
+		{
+			return Read(buffer, len, &deadline);
+		}
+
+		void LinuxSerialPort::Flush() const
+		{
+			tcflush(m_Fd, TCIOFLUSH);
+		}
+
+		int32_t LinuxSerialPort::Read(char* buffer, uint32_t len, const Util::Deadline* deadline) const
+		{
+			if (m_Fd == -1)
+				return -1;
+
+			bool waited = false;
+			while (true)
+			{
+				ssize_t received = read(m_Fd, buffer, len);
+				if (received > 0)
+					return received;
+
+				if (received == -1 && errno == EINTR)
+					continue;
+
+				if (received == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+					return -1;
+
+				// nothing buffered yet (the tty may return 0 instead of EAGAIN), wait for the port
+				// to become readable: once with the receive timeout or until the deadline
+				if (deadline)
+				{
+					if (deadline->IsExpired())
+						return 0;
+
+					WaitFor(POLLIN, deadline->GetRemaining());
+					continue;
+				}
+
+				if (waited || !WaitFor(POLLIN, m_ReceiveTimeout))
+					return 0;
+
+				waited = true;
+			}
+		}
+
+		bool LinuxSerialPort::WaitFor(short events, int32_t timeout) const
+		{
+			pollfd fd = { m_Fd, events, 0 };
+
+			int ready;
+			do
+			{
+				ready = poll(&fd, 1, timeout);
+			} while (ready == -1 && errno == EINTR);
+
+			return ready > 0 && (fd.revents & events);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#ifndef LINUX_SERIAL_PORT_H_
+#define LINUX_SERIAL_PORT_H_
+
+// user libraries
+#include "UART/IUartDriver.h"
+
+namespace Serial
+{
+	namespace Linux
+	{
+		///
+		/// Serial port on top of termios. The file descriptor is opened non-blocking and
+		/// Receive waits for readiness with poll, so it returns as soon as data is available
+		/// instead of waiting for a fixed read timeout. The timeout is only the upper bound
+		/// when nothing arrives at all.
+		///
+		class LinuxSerialPort : public IUartDriver
+		{
+		public:
+			///
+			/// Constructs a (closed) serial port
+			///
+			/// @param device		Path of the tty (e.g. /dev/ttyUSB0)
+			/// @param baudrate		Baud rate, all RN4020 rates (2400 up to 921600) are supported
+			/// @param databits		Data bits
+			/// @param parity		Parity bit
+			/// @param stopbits		Stop bits (1.5 is not supported by termios)
+			///
+			LinuxSerialPort(const char* device, BaudRate baudrate, DataBit databits, ParityBit parity, StopBit stopbits);
+			~LinuxSerialPort();
+
+			bool Open();
+			bool Close();
+			int32_t Send(const char* buffer, uint32_t len) const override;
+			int32_t SendVector(const SerialBuffer* buffers, uint8_t count) const override;
+			int32_t Receive(char* buffer, uint32_t len) const override;
+			int32_t ReceiveUntil(char* buffer, uint32_t len, const Util::Deadline& deadline) const override;
+			void Flush() const override;
+
+			const char* GetDevice() const
+			{
+				return m_Device;
+			}
+
+			///
+			/// Gets the file descriptor of the opened port, can be used to wait on the port
+			/// from an event loop.
+			///
+			/// @return				the file descriptor, -1 if not opened
+			///
+			int GetFileDescriptor() const
+			{
+				return m_Fd;
+			}
+
+			///
+			/// Sets the maximum time Receive waits for data to become available. Must be
+			/// set before Open.
+			///
+			/// @param timeout		Timeout in ms (-1 waits forever; 0 only polls)
+			///
+			void SetReceiveTimeout(int32_t timeout)
+			{
+				m_ReceiveTimeout = timeout;
+			}
+
+			///
+			/// Sets the maximum time Send waits for the output buffer to drain when it is full
+			///
+			/// @param timeout		Timeout in ms (-1 waits forever)
+			///
+			void SetSendTimeout(int32_t timeout)
+			{
+				m_SendTimeout = timeout;
+			}
+
+			///
+			/// Enables RTS/CTS hardware flow control, required when the module has
+			/// FEATURE_UART_FLOWCONTROL set. Must be set before Open.
+			///
+			/// @param enable		Enables the flow control
+			///
+			void SetFlowControl(bool enable)
+			{
+				m_FlowControl = enable;
+			}
+
+		private:
+			const char* m_Device;
+			int m_Fd;
+			int32_t m_ReceiveTimeout;
+			int32_t m_SendTimeout;
+			bool m_FlowControl;
+
+			bool WaitFor(short events, int32_t timeout) const;
+			int32_t Read(char* buffer, uint32_t len, const Util::Deadline* deadline) const;
+		};
+	}
+}
+
+#endif // !LINUX_SERIAL_PORT_H_
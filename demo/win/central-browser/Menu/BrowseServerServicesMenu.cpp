@@ -17,17 +17,26 @@ namespace Console
 	{
 		Clear();
 
-		UUID services[20];
-		uint8_t listed = 0;
-		if (!m_Device.GetDriver().ListServerServices(services, 20, &listed))
+		// a single listing for the whole screen
+		GattTable table;
+		if (!m_Device.GetDriver().DiscoverServer(&table))
 			return;
 
-		for (uint8_t i = 0; i < listed; ++i)
+		for (uint8_t i = 0; i < table.GetServiceCount(); ++i)
 		{
-			char buf[32];
-			snprintf(buf, sizeof(buf), "%04X", services[i].GetShortUUID());
+			const GattTable::Service& service = table.GetService(i);
 
+			char buf[32];
+			snprintf(buf, sizeof(buf), "%04X", service.Uuid.GetShortUUID());
 			AddItem(unique_ptr<MenuItem>(make_unique<EmptyItem>(buf)));
+
+			for (uint8_t j = service.First; j < service.First + service.Count; ++j)
+			{
+				const GattTable::Characteristic& characteristic = table.GetCharacteristic(j);
+
+				snprintf(buf, sizeof(buf), "  %04X (%04X)%s", characteristic.Uuid.GetShortUUID(), characteristic.Handle, characteristic.IsConfiguration ? " config" : "");
+				AddItem(unique_ptr<MenuItem>(make_unique<EmptyItem>(buf)));
+			}
 		}
 	}
 }
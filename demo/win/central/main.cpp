@@ -46,9 +46,13 @@ int main()
 	cout << "Services set: " << device.SetServices(services) << endl;
 	cout << "Scanning.." << endl;*/
 
+	// only the client is stored, other advertisements are dropped before parsing
+	ScanFilter filter;
+	filter.SetNamePrefix("MyClient");
+
 	BluetoothLEPeripheral peripherals[16];
 	uint8_t found = 0;
-	cout << "Scanned: " << device.ScanPeripherals(peripherals, 16, &found) << endl;
+	cout << "Scanned: " << device.ScanPeripherals(peripherals, 16, &found, 1000, &filter) << endl;
 	cout << " Found " << static_cast<int>(found) << " devices" << endl;
 	if (found < 1)
 		return 1;
@@ -62,18 +66,7 @@ int main()
 
 	return 1;
 
-	BluetoothLEPeripheral* peripheral = NULL;
-	for (uint8_t i = 0; i < found; ++i)
-	{
-		if (strcmp(peripherals[i].GetName(), "MyClient") != 0)
-			continue;
-
-		peripheral = &peripherals[i];
-		break;
-	}
-
-	if (peripheral == NULL)
-		return 1;
+	BluetoothLEPeripheral* peripheral = &peripherals[0];
 
 	char buf[18];
 	peripheral->GetMACAddress().ToCharArray(buf, sizeof(buf));
@@ -88,7 +81,7 @@ int main()
 
 	LongClientCharacteristic characteristics[20];
 	uint8_t len;
-	if (!driver.ListClientCharacteristics(Bluetooth::UUID(0x180F), characteristics, 20, &len))
+	if (!driver.ListClientCharacteristics("180F"_uuid, characteristics, 20, &len))
 		return 1;
 
 	while (true)